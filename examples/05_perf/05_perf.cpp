@@ -53,10 +53,11 @@ int main(int argc, char* argv[]) {
             buffers.emplace_back(std::move(buffer));
         }
 
+        std::vector<vrt::KernelLaunch> launches;
         for (int i = 0; i < 15; i++) {
-            uint64_t addr = buffers[i].getPhysAddr();
-            kernels[i].start(size * sizeof(uint32_t) / 64, buffers[i].getPhysAddr());
+            launches.push_back(kernels[i].bind(size * sizeof(uint32_t) / 64, buffers[i].getPhysAddr()));
         }
+        device.launchMany(launches);
 
         auto start_time = std::chrono::high_resolution_clock::now();
         
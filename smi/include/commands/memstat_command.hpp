@@ -0,0 +1,85 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef MEMSTAT_COMMAND_HPP
+#define MEMSTAT_COMMAND_HPP
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "utils/memory_stats.hpp"
+
+/**
+ * @brief Class for displaying the device memory usage of a running VRT application.
+ *
+ * The MemstatCommand class reads the allocator statistics that a VRT application publishes in a
+ * shared memory segment while it holds the device, and prints usage, fragmentation and
+ * allocation latency per memory range and per HBM port.
+ */
+class MemstatCommand {
+   public:
+    /**
+     * @brief Constructor for MemstatCommand.
+     *
+     * @param device The BDF of the device to report on.
+     */
+    MemstatCommand(const std::string& device);
+
+    /**
+     * @brief Executes the memstat command.
+     */
+    void execute();
+
+   private:
+    std::string device;  ///< The BDF of the device to report on.
+
+    /**
+     * @brief Prints the counters of one memory range.
+     *
+     * @param name Name of the memory range.
+     * @param counters The counters of the range.
+     */
+    void printRange(const std::string& name, const MemoryRangeCounters& counters) const;
+
+    /**
+     * @brief Prints the usage of the HBM ports that have been used.
+     *
+     * @param stats The statistics segment.
+     */
+    void printPorts(const MemoryStatsBlock& stats) const;
+
+    /**
+     * @brief Formats a byte count with a binary unit.
+     *
+     * @param bytes The byte count.
+     * @return The formatted byte count.
+     */
+    static std::string formatBytes(uint64_t bytes);
+};
+
+#endif  // MEMSTAT_COMMAND_HPP
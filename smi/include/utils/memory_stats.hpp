@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef MEMORY_STATS_HPP
+#define MEMORY_STATS_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Layout of the memory statistics segment published by the VRT allocator. Must match
+ * vrt/include/allocator/memory_stats.hpp for MEMORY_STATS_VERSION.
+ */
+
+/// Magic number at the start of a valid segment ("VRTM")
+#define MEMORY_STATS_MAGIC 0x5652544D
+/// Layout version understood by v80-smi
+#define MEMORY_STATS_VERSION 1
+/// Number of HBM ports tracked
+#define MEMORY_STATS_PORTS 32
+/// Number of memory ranges tracked (HBM, DDR)
+#define MEMORY_STATS_RANGES 2
+/// Name of the segment, formatted with the PCIe bus of the device
+#define MEMORY_STATS_SHM_NAME "/vrt_memstat_%s"
+
+/**
+ * @brief Structure holding the live counters of one memory range.
+ */
+struct MemoryRangeCounters {
+    std::atomic<uint64_t> size;               ///< Size of the range in bytes
+    std::atomic<uint64_t> bytesInUse;         ///< Bytes handed out to the application
+    std::atomic<uint64_t> peakBytesInUse;     ///< High-water mark of bytesInUse
+    std::atomic<uint64_t> freeBytes;          ///< Bytes not claimed by blocks or superblocks
+    std::atomic<uint64_t> largestFreeBlock;   ///< Largest contiguous free block in bytes
+    std::atomic<uint64_t> allocations;        ///< Number of successful allocations
+    std::atomic<uint64_t> deallocations;      ///< Number of deallocations
+    std::atomic<uint64_t> failedAllocations;  ///< Number of allocations that threw
+    std::atomic<uint64_t> allocationNs;       ///< Total time spent in allocate in nanoseconds
+    std::atomic<uint64_t> maxAllocationNs;    ///< Slowest allocation in nanoseconds
+};
+
+/**
+ * @brief Structure holding all counters of an allocator, as laid out in shared memory.
+ */
+struct MemoryStatsBlock {
+    uint32_t magic;                                            ///< MEMORY_STATS_MAGIC when valid
+    uint32_t version;                                          ///< MEMORY_STATS_VERSION of writer
+    int32_t pid;                                               ///< Process id of the writer
+    uint32_t reserved;                                         ///< Padding
+    MemoryRangeCounters ranges[MEMORY_STATS_RANGES];           ///< Counters of HBM and DDR
+    std::atomic<uint64_t> portBytesInUse[MEMORY_STATS_PORTS];  ///< Bytes in use per HBM port
+    std::atomic<uint64_t> portPeakBytes[MEMORY_STATS_PORTS];   ///< Peak bytes per HBM port
+};
+
+#endif  // MEMORY_STATS_HPP
@@ -35,6 +35,7 @@ ArgParser::ArgParser() {
     addCommand("inspect", [this]() { currentCommand = "inspect"; });
     addCommand("reload", [this]() { currentCommand = "reload"; });
     addCommand("reset", [this]() { currentCommand = "reset"; });
+    addCommand("memstat", [this]() { currentCommand = "memstat"; });
 }
 
 void ArgParser::parse(int argc, char* argv[]) {
@@ -179,6 +180,7 @@ void ArgParser::printHelp() const {
         << "  inspect              Inspect a vrtbin before programming\n"
         << "  reload               Reloads the PCIe handler for device\n"
         << "  reset                Resets the device to a clean state\n"
+        << "  memstat              Show device memory usage of the running VRT application\n"
         << "Options:\n"
         << "  -d, --device <device>  Specify the device (e.g., 21:00.0)\n"
         << "  -i, --image <image>    Specify the image file to program. Only relevant for "
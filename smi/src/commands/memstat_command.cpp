@@ -0,0 +1,127 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "commands/memstat_command.hpp"
+
+MemstatCommand::MemstatCommand(const std::string& device) : device(device) {}
+
+void MemstatCommand::execute() {
+    if (device.empty()) {
+        std::cerr << "Error: Device not specified" << std::endl;
+        return;
+    }
+    std::string bus = device.substr(0, device.find(':'));
+    char name[64];
+    snprintf(name, sizeof(name), MEMORY_STATS_SHM_NAME, bus.c_str());
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        std::cout << "No VRT application is using device " << bus << ":00.0" << std::endl;
+        return;
+    }
+    void* mapping = mmap(nullptr, sizeof(MemoryStatsBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: could not map " << name << std::endl;
+        return;
+    }
+    const auto* stats = static_cast<const MemoryStatsBlock*>(mapping);
+    const auto* magic = reinterpret_cast<const std::atomic<uint32_t>*>(&stats->magic);
+    if (magic->load(std::memory_order_acquire) != MEMORY_STATS_MAGIC ||
+        stats->version != MEMORY_STATS_VERSION) {
+        std::cerr << "Error: " << name << " has an unknown layout" << std::endl;
+    } else if (kill(stats->pid, 0) != 0 && errno == ESRCH) {
+        // the application ended without unlinking the segment
+        std::cout << "No VRT application is using device " << bus << ":00.0 (stale statistics "
+                  << "of process " << stats->pid << ")" << std::endl;
+    } else {
+        std::cout << "Device " << bus << ":00.0, used by process " << stats->pid << std::endl;
+        printf(
+            "+--------+------------+------------+------------+------------+-------+----------+---"
+            "-------+--------+\n");
+        printf(
+            "| Range  | Size       | In use     | Peak       | Largest    | Frag  | Allocs   | Fr"
+            "ees    | Failed |\n");
+        printf(
+            "+--------+------------+------------+------------+------------+-------+----------+---"
+            "-------+--------+\n");
+        printRange("HBM", stats->ranges[0]);
+        printRange("DDR", stats->ranges[1]);
+        printf(
+            "+--------+------------+------------+------------+------------+-------+----------+---"
+            "-------+--------+\n");
+        printPorts(*stats);
+    }
+    munmap(mapping, sizeof(MemoryStatsBlock));
+}
+
+void MemstatCommand::printRange(const std::string& name,
+                                const MemoryRangeCounters& counters) const {
+    uint64_t freeBytes = counters.freeBytes.load();
+    uint64_t largest = counters.largestFreeBlock.load();
+    uint64_t allocations = counters.allocations.load();
+    double fragmentation = freeBytes == 0 ? 0.0 : 100.0 * (1.0 - (double)largest / freeBytes);
+    printf("| %-6s | %-10s | %-10s | %-10s | %-10s | %4.1f%% | %-8lu | %-8lu | %-6lu |\n",
+           name.c_str(), formatBytes(counters.size.load()).c_str(),
+           formatBytes(counters.bytesInUse.load()).c_str(),
+           formatBytes(counters.peakBytesInUse.load()).c_str(), formatBytes(largest).c_str(),
+           fragmentation, allocations, counters.deallocations.load(),
+           counters.failedAllocations.load());
+    if (allocations != 0) {
+        printf("|        | allocate: avg %.0f ns, max %lu ns\n",
+               (double)counters.allocationNs.load() / allocations,
+               counters.maxAllocationNs.load());
+    }
+}
+
+void MemstatCommand::printPorts(const MemoryStatsBlock& stats) const {
+    bool headerPrinted = false;
+    for (int port = 0; port < MEMORY_STATS_PORTS; port++) {
+        uint64_t peak = stats.portPeakBytes[port].load();
+        if (peak == 0) {
+            continue;
+        }
+        if (!headerPrinted) {
+            printf("+--------+------------+------------+\n");
+            printf("| Port   | In use     | Peak       |\n");
+            printf("+--------+------------+------------+\n");
+            headerPrinted = true;
+        }
+        printf("| %-6d | %-10s | %-10s |\n", port,
+               formatBytes(stats.portBytesInUse[port].load()).c_str(), formatBytes(peak).c_str());
+    }
+    if (headerPrinted) {
+        printf("+--------+------------+------------+\n");
+    }
+}
+
+std::string MemstatCommand::formatBytes(uint64_t bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = bytes;
+    int unit = 0;
+    while (value >= 1024 && unit < 4) {
+        value /= 1024;
+        unit++;
+    }
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.2f %s", value, units[unit]);
+    return buffer;
+}
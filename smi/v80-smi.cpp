@@ -23,6 +23,7 @@
 #include "arg_parser.hpp"
 #include "commands/inspect_command.hpp"
 #include "commands/list_command.hpp"
+#include "commands/memstat_command.hpp"
 #include "commands/partial_program_command.hpp"
 #include "commands/program_command.hpp"
 #include "commands/query_command.hpp"
@@ -67,6 +68,9 @@ int main(int argc, char* argv[]) {
     } else if (parser.isCommand("reload")) {
         ReloadCommand reloadCommand(parser.getDevice());
         reloadCommand.execute();
+    } else if (parser.isCommand("memstat")) {
+        MemstatCommand memstatCommand(parser.getDevice());
+        memstatCommand.execute();
     } else if (parser.isCommand("reset")) {
         ResetCommand resetCommand(parser.getDevice());
         resetCommand.execute();
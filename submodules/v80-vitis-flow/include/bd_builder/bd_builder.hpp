@@ -67,6 +67,8 @@ class BdBuilder {
         0x00001000;  ///< Size of each kernel's memory map
     static constexpr uint16_t MAX_ALLOCABLE_BW_HBM_PER_CHANNEL =
         400;                      ///< Maximum allocable bandwidth for HBM per channel in MBps
+    static constexpr uint8_t HBM_PSEUDO_CHANNELS = 32;  ///< Number of 1 GiB HBM pseudo-channels
+    static constexpr uint16_t HBM_REMOTE_BW = 5;  ///< Bandwidth to non-home channels in MBps
     std::vector<Kernel> kernels;  ///< List of kernels to include in the design
     std::vector<Connection> streamConnections;  ///< List of streaming connections between kernels
     uint64_t targetClockFreq;                   ///< Target clock frequency in Hz
@@ -127,9 +129,10 @@ class BdBuilder {
      * @brief Generates TCL commands for Quality of Service (QoS) settings.
      * @param slave_offset Offset for slave addressing.
      * @param bw Bandwidth allocation.
+     * @param homePort HBM pseudo-channel of a kernel slave, -1 to weight all channels equally.
      * @return String containing TCL commands for QoS configuration.
      */
-    std::string genQoS(int slave_offset, int bw);
+    std::string genQoS(int slave_offset, int bw, int homePort = -1);
 
     /**
      * @brief Generates TCL commands to assign an address to a slave interface.
@@ -185,6 +188,17 @@ class BdBuilder {
      */
     std::string connectClkWiz();
 
+    /**
+     * @brief Assigns a home HBM pseudo-channel to each AXI-MM interface.
+     *
+     * Interfaces are spread round-robin over the pseudo-channels in the order they are
+     * connected to the NoC, and genQoS() reserves the bandwidth of each interface on its home
+     * channel. The assignment, together with the kernel arguments served by each interface, is
+     * recorded in the system map for placement by the runtime. Segmented designs share one NoC
+     * slave between all interfaces, so no assignment is made.
+     */
+    void assignMemoryPorts();
+
     /**
      * @brief Exports the system memory map to a file.
      */
@@ -33,6 +33,19 @@
 #include "arg_parser.hpp"
 #include "map_entry.hpp"
 
+/**
+ * @brief Structure describing the HBM pseudo-channel an AXI-MM interface is attached to.
+ *
+ * Buffers of the listed arguments are placed on this pseudo-channel by the runtime, so
+ * the kernel's traffic stays on its own channel instead of crossing the NoC.
+ */
+struct MemoryConnection {
+    std::string kernelName;              ///< The name of the kernel
+    std::string interfaceName;           ///< The name of the AXI-MM interface on the kernel
+    std::vector<std::string> arguments;  ///< The kernel arguments served by the interface
+    uint8_t hbmPort;                     ///< Index of the HBM pseudo-channel (1 GiB each)
+};
+
 /**
  * @brief Class representing the complete system memory map for a hardware design.
  *
@@ -43,6 +56,7 @@
 class SystemMap {
     std::vector<MapEntry> entries;  ///< List of memory map entries for all components
     std::vector<StreamingConnection> qdmaStreamConnections;  ///< List of QDMA streaming connections
+    std::vector<MemoryConnection> memoryConnections;         ///< HBM ports of AXI-MM interfaces
     uint64_t targetClockFreq;                                ///< Target clock frequency in Hz
     std::string SYSTEM_MAP_OUTPUT = "system.map";  ///< Output file name for the system map
     bool segmented;                                ///< Flag indicating if the design is segmented
@@ -89,6 +103,12 @@ class SystemMap {
      */
     void addStreamConnection(StreamingConnection connection);
 
+    /**
+     * @brief Adds the HBM port assignment of an AXI-MM interface to the system map.
+     * @param connection MemoryConnection object to add to the system.
+     */
+    void addMemoryConnection(MemoryConnection connection);
+
     /**
      * @brief Gets the list of memory map entries in the system.
      * @return Vector of MapEntry objects in the system map.
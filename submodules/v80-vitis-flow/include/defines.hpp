@@ -105,6 +105,26 @@
  */
 #define XML_NODE_REGISTER "register"
 
+/**
+ * @brief XML node name for kernel argument definitions.
+ */
+#define XML_NODE_ARG "Arg"
+
+/**
+ * @brief XML node name for the hardware references of a kernel argument.
+ */
+#define XML_NODE_HW_REF "hwRef"
+
+/**
+ * @brief XML attribute name for argument name.
+ */
+#define XML_ATTR_ARG_NAME "ArgName"
+
+/**
+ * @brief XML attribute name for the interface of a hardware reference.
+ */
+#define XML_ATTR_HW_REF_INTF "interface"
+
 /**
  * @brief XML attribute name for interface name.
  */
@@ -21,6 +21,7 @@
 #pragma once
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -57,6 +58,7 @@ class Kernel {
     AreaEstimates estimates;            ///< Resource utilization estimates
     std::vector<Interface> interfaces;  ///< List of kernel interfaces
     std::vector<Register> registers;    ///< List of registers in the kernel
+    std::map<std::string, std::string> argumentInterfaces;  ///< Interface of each argument
 
    public:
     /**
@@ -197,6 +199,20 @@ class Kernel {
      */
     void addRegister(Register reg);
 
+    /**
+     * @brief Records the memory interface an argument is accessed through.
+     * @param argument Name of the kernel argument.
+     * @param interfaceName Name of the AXI-MM interface serving the argument.
+     */
+    void addArgumentInterface(const std::string& argument, const std::string& interfaceName);
+
+    /**
+     * @brief Gets the arguments accessed through a memory interface.
+     * @param interfaceName Name of the AXI-MM interface.
+     * @return Vector of argument names served by the interface.
+     */
+    std::vector<std::string> getArgumentsOfInterface(const std::string& interfaceName);
+
     /**
      * @brief Sets the name of the kernel.
      * @param name String containing the kernel name.
@@ -72,7 +72,35 @@ BdBuilder::BdBuilder(std::vector<Kernel> kernels, std::vector<Connection> connec
     }
 }
 
+void BdBuilder::assignMemoryPorts() {
+    if (segmented) {
+        utils::Logger::log(utils::LogLevel::INFO, __PRETTY_FUNCTION__,
+                           "Segmented design, no HBM ports assigned to interfaces");
+        return;
+    }
+    int axiMmIntfIdx = 0;
+    for (auto& kernel : kernels) {
+        for (auto& intf : kernel.getInterfaces()) {
+            if (intf.getInterfaceType() != "axi4full") {
+                continue;
+            }
+            MemoryConnection memoryConnection;
+            memoryConnection.kernelName = kernel.getName();
+            memoryConnection.interfaceName = intf.getInterfaceName();
+            memoryConnection.arguments = kernel.getArgumentsOfInterface(intf.getInterfaceName());
+            memoryConnection.hbmPort = axiMmIntfIdx % HBM_PSEUDO_CHANNELS;
+            utils::Logger::log(utils::LogLevel::INFO, __PRETTY_FUNCTION__,
+                               "Assigning HBM port {} to interface {} of kernel {}",
+                               std::to_string(memoryConnection.hbmPort),
+                               memoryConnection.interfaceName, memoryConnection.kernelName);
+            systemMap.addMemoryConnection(memoryConnection);
+            axiMmIntfIdx++;
+        }
+    }
+}
+
 void BdBuilder::buildBlockDesign() {
+    assignMemoryPorts();
     std::ifstream inputBlockDesignFile;
     if (platform == Platform::SIMULATOR) {
         inputBlockDesignFile.open(INPUT_FILE_SIM);
@@ -134,7 +162,9 @@ void BdBuilder::buildBlockDesign() {
             for (auto& kernel : kernels) {
                 for (auto& intf : kernel.getInterfaces()) {
                     if (intf.getInterfaceType() == "axi4full") {
-                        blockDesignFile << genQoS(axiMmIntfIdx + 4, bw);
+                        // same order and home port as in assignMemoryPorts()
+                        blockDesignFile << genQoS(axiMmIntfIdx + 4, bw,
+                                                  axiMmIntfIdx % HBM_PSEUDO_CHANNELS);
                         axiMmIntfIdx++;
                     }
                 }
@@ -384,7 +414,7 @@ std::string BdBuilder::assignSlaveAddress(std::string krnl_name, int idx, Interf
     return ss.str();
 }
 
-std::string BdBuilder::genQoS(int slave_offset, int bw) {
+std::string BdBuilder::genQoS(int slave_offset, int bw, int homePort) {
     std::stringstream ss;
     utils::Logger::log(utils::LogLevel::INFO, __PRETTY_FUNCTION__,
                        "Generating QoS with bandwidth: {}", bw);
@@ -615,74 +645,19 @@ std::string BdBuilder::genQoS(int slave_offset, int bw) {
            << "M00_AXI {read_bw {5} write_bw {5} read_avg_burst {64} write_avg_burst {64}}}] "
               "[get_bd_intf_pins /axi_noc_cips/";
     } else {
-        ss << "set_property -dict [list CONFIG.CONNECTIONS {"
-           << "HBM10_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "M03_INI {read_bw {800} write_bw {800} read_avg_burst {64} write_avg_burst {64}} "
-           << "HBM10_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM5_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM15_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM0_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM15_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM1_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM5_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM1_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM6_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM14_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM0_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM8_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM12_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM6_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM12_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM8_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM14_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM3_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM3_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM4_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM9_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM4_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM9_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
+        // pseudo-channel 2n + 1 of controller n is reached through PORT3, 2n through PORT1. All
+        // channels stay reachable, only the home channel gets the bandwidth of the interface.
+        ss << "set_property -dict [list CONFIG.CONNECTIONS {";
+        for (int channel = 0; channel < HBM_PSEUDO_CHANNELS; channel++) {
+            int channelBw = (homePort < 0 || channel == homePort) ? bw : HBM_REMOTE_BW;
+            ss << "HBM" << channel / 2 << "_PORT" << (channel % 2 ? 3 : 1) << " {read_bw {"
+               << channelBw << "} write_bw {" << channelBw
+               << "} read_avg_burst {4} write_avg_burst {4}} ";
+        }
+        ss << "M03_INI {read_bw {800} write_bw {800} read_avg_burst {64} write_avg_burst {64}} "
            << "M01_INI {read_bw {800} write_bw {800} read_avg_burst {64} write_avg_burst {64}} "
-           << "HBM11_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM11_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM7_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM13_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM7_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM2_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "HBM2_PORT1 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}} "
-           << "M00_AXI {read_bw {5} write_bw {5} read_avg_burst {64} write_avg_burst {64}} "
-           << "HBM13_PORT3 {read_bw {" << bw << "} write_bw {" << bw
-           << "} read_avg_burst {4} write_avg_burst {4}}}] [get_bd_intf_pins /axi_noc_cips/";
+           << "M00_AXI {read_bw {5} write_bw {5} read_avg_burst {64} write_avg_burst {64}}}] "
+              "[get_bd_intf_pins /axi_noc_cips/";
     }
 
     if (slave_offset < 10) {
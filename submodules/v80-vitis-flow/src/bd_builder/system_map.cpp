@@ -74,6 +74,16 @@ void SystemMap::printToFile() {
                                                                              : "HostToDevice"));
     }
 
+    for (auto& mc : memoryConnections) {
+        xmlNodePtr newNode = xmlNewChild(rootNode, NULL, BAD_CAST "Memory", NULL);
+        xmlNewChild(newNode, NULL, BAD_CAST "kernel", BAD_CAST mc.kernelName.c_str());
+        xmlNewChild(newNode, NULL, BAD_CAST "interface", BAD_CAST mc.interfaceName.c_str());
+        xmlNewChild(newNode, NULL, BAD_CAST "port", BAD_CAST std::to_string(mc.hbmPort).c_str());
+        for (auto& argument : mc.arguments) {
+            xmlNewChild(newNode, NULL, BAD_CAST "argument", BAD_CAST argument.c_str());
+        }
+    }
+
     xmlSaveFormatFileEnc("system_map.xml", doc, "UTF-8", 1);
     xmlFreeDoc(doc);
     xmlCleanupParser();
@@ -93,4 +103,8 @@ void SystemMap::setClockFreq(uint64_t freq) { this->targetClockFreq = freq; }
 
 void SystemMap::addStreamConnection(StreamingConnection connection) {
     this->qdmaStreamConnections.emplace_back(connection);
-}
\ No newline at end of file
+}
+
+void SystemMap::addMemoryConnection(MemoryConnection connection) {
+    this->memoryConnections.emplace_back(connection);
+}
@@ -47,6 +47,7 @@ Emulator::Emulator(std::vector<std::string> paths, std::vector<Kernel> krnls,
 
 void Emulator::print() {
     std::ofstream out("tb.cpp");
+    out << "#include <algorithm>\n";
     out << "#include <iostream>\n";
     out << "#include <ap_fixed.h>\n";
     out << "#include <hls_stream.h>\n";
@@ -238,14 +239,73 @@ void Emulator::print() {
 
     out << "\t\t\tzmq::message_t data;\n";
     out << "\t\t\tsocket.recv(data);\n";
-    out << "\t\t\tvoid* buffer = new uint8_t[bufferSize];\n";
-    out << "\t\t\tmemcpy(buffer, data.data(), bufferSize);\n";
+    // populate with an offset updates a sub-range of an existing buffer; the full size is not
+    // known here, so a range of an unknown buffer is rejected instead of creating a short one
+    out << "\t\t\tif (root.isMember(\"offset\")) {\n";
+    out << "\t\t\t\tsize_t offset = root[\"offset\"].asUInt64();\n";
+    out << "\t\t\t\tif (buffers.find(name) == buffers.end()) {\n";
+    out << "\t\t\t\t\tstd::cerr << \"populate: unknown buffer \" << name << std::endl;\n";
+    out << "\t\t\t\t} else if (offset < bufferSizes[name]) {\n";
+    out << "\t\t\t\t\tmemcpy(static_cast<uint8_t*>(buffers[name]) + offset, data.data(), "
+           "std::min(bufferSize, bufferSizes[name] - offset));\n";
+    out << "\t\t\t\t}\n";
+    out << "\t\t\t} else {\n";
+    // device addresses are reused, so a full populate replaces any buffer left at the address
+    out << "\t\t\t\tif (buffers.find(name) != buffers.end()) {\n";
+    out << "\t\t\t\t\tdelete[] static_cast<uint8_t*>(buffers[name]);\n";
+    out << "\t\t\t\t}\n";
+    out << "\t\t\t\tvoid* buffer = new uint8_t[bufferSize];\n";
+    out << "\t\t\t\tmemcpy(buffer, data.data(), bufferSize);\n";
 
-    out << "\t\t\tbuffers[name] = buffer;\n";
-    out << "\t\t\tbufferSizes[name] = bufferSize;\n";
+    out << "\t\t\t\tbuffers[name] = buffer;\n";
+    out << "\t\t\t\tbufferSizes[name] = bufferSize;\n";
+    out << "\t\t\t}\n";
     out << "\t\t\tsocket.send(zmq::message_t(\"OK\", 2), zmq::send_flags::none);\n";  // Send OK
                                                                                       // after
                                                                                       // populate
+    // allocate creates a zeroed buffer for device-only buffers, no data frame follows
+    out << "\t\t} else if (command == \"allocate\") {\n";
+    out << "\t\t\tstd::string name = root[\"name\"].asString();\n";
+    out << "\t\t\tsize_t bufferSize = root[\"size\"].asUInt64();\n";
+    out << "\t\t\tif (buffers.find(name) != buffers.end()) {\n";
+    out << "\t\t\t\tdelete[] static_cast<uint8_t*>(buffers[name]);\n";
+    out << "\t\t\t}\n";
+    out << "\t\t\tbuffers[name] = new uint8_t[bufferSize]();\n";
+    out << "\t\t\tbufferSizes[name] = bufferSize;\n";
+    out << "\t\t\tsocket.send(zmq::message_t(\"OK\", 2), zmq::send_flags::none);\n";
+    // free releases the buffer of a destroyed host-side Buffer
+    out << "\t\t} else if (command == \"free\") {\n";
+    out << "\t\t\tstd::string name = root[\"name\"].asString();\n";
+    out << "\t\t\tauto it = buffers.find(name);\n";
+    out << "\t\t\tif (it != buffers.end()) {\n";
+    out << "\t\t\t\tdelete[] static_cast<uint8_t*>(it->second);\n";
+    out << "\t\t\t\tbuffers.erase(it);\n";
+    out << "\t\t\t\tbufferSizes.erase(name);\n";
+    out << "\t\t\t}\n";
+    out << "\t\t\tsocket.send(zmq::message_t(\"OK\", 2), zmq::send_flags::none);\n";
+    // populate_batch writes several buffer ranges from one concatenated data frame
+    out << "\t\t} else if (command == \"populate_batch\") {\n";
+    out << "\t\t\tzmq::message_t data;\n";
+    out << "\t\t\tsocket.recv(data);\n";
+    out << "\t\t\tsize_t dataOffset = 0;\n";
+    out << "\t\t\tfor (const auto& entry : root[\"entries\"]) {\n";
+    out << "\t\t\t\tstd::string name = entry[\"name\"].asString();\n";
+    out << "\t\t\t\tsize_t offset = entry[\"offset\"].asUInt64();\n";
+    out << "\t\t\t\tsize_t size = std::min<size_t>(entry[\"size\"].asUInt64(), "
+           "data.size() - dataOffset);\n";
+    out << "\t\t\t\tconst uint8_t* src = static_cast<const uint8_t*>(data.data()) + "
+           "dataOffset;\n";
+    out << "\t\t\t\tif (buffers.find(name) != buffers.end()) {\n";
+    out << "\t\t\t\t\tif (offset < bufferSizes[name]) {\n";
+    out << "\t\t\t\t\t\tmemcpy(static_cast<uint8_t*>(buffers[name]) + offset, src, "
+           "std::min(size, bufferSizes[name] - offset));\n";
+    out << "\t\t\t\t\t}\n";
+    out << "\t\t\t\t} else {\n";
+    out << "\t\t\t\t\tstd::cerr << \"populate_batch: unknown buffer \" << name << std::endl;\n";
+    out << "\t\t\t\t}\n";
+    out << "\t\t\t\tdataOffset += size;\n";
+    out << "\t\t\t}\n";
+    out << "\t\t\tsocket.send(zmq::message_t(\"OK\", 2), zmq::send_flags::none);\n";
     out << "\t\t} else if (command == \"stream_in\") {\n";
     out << "\t\t\tstd::string name = root[\"name\"].asString();\n";
     out << "\t\t\tzmq::message_t data;\n";
@@ -365,12 +425,42 @@ void Emulator::print() {
 
     out << "\t\t\t} else if (type == \"buffer\") {\n";
     out << "\t\t\t\tstd::string name = root[\"name\"].asString();\n";
-    out << "\t\t\t\tif (buffers.find(name) != buffers.end()) {\n";
+    out << "\t\t\t\tif (buffers.find(name) != buffers.end() && root.isMember(\"offset\")) {\n";
+    out << "\t\t\t\t\tsize_t offset = std::min<size_t>(root[\"offset\"].asUInt64(), "
+           "bufferSizes[name]);\n";
+    out << "\t\t\t\t\tsize_t size = std::min<size_t>(root[\"size\"].asUInt64(), "
+           "bufferSizes[name] - offset);\n";
+    out << "\t\t\t\t\tresponse = createJsonBuffer(static_cast<uint8_t*>(buffers[name]) + "
+           "offset, size);\n";
+    out << "\t\t\t\t} else if (buffers.find(name) != buffers.end()) {\n";
     out << "\t\t\t\t\tresponse = createJsonBuffer(static_cast<uint8_t*>(buffers[name]), "
            "bufferSizes[name]);\n";
     out << "\t\t\t\t}\n";
     out << "\t\t\t}\n";
 
+    out << "\t\t\tstd::string responseStr = Json::writeString(Json::StreamWriterBuilder(), "
+           "response);\n";
+    out << "\t\t\tsocket.send(zmq::message_t(responseStr.c_str(), responseStr.size()), "
+           "zmq::send_flags::none);\n";
+    // fetch_batch returns several buffer ranges concatenated, missing bytes read as zero
+    out << "\t\t} else if (command == \"fetch_batch\") {\n";
+    out << "\t\t\tJson::Value response(Json::arrayValue);\n";
+    out << "\t\t\tfor (const auto& entry : root[\"entries\"]) {\n";
+    out << "\t\t\t\tstd::string name = entry[\"name\"].asString();\n";
+    out << "\t\t\t\tsize_t offset = entry[\"offset\"].asUInt64();\n";
+    out << "\t\t\t\tsize_t size = entry[\"size\"].asUInt64();\n";
+    out << "\t\t\t\tsize_t available = 0;\n";
+    out << "\t\t\t\tif (buffers.find(name) != buffers.end() && offset < bufferSizes[name]) {\n";
+    out << "\t\t\t\t\tavailable = std::min(size, bufferSizes[name] - offset);\n";
+    out << "\t\t\t\t\tconst uint8_t* src = static_cast<uint8_t*>(buffers[name]) + offset;\n";
+    out << "\t\t\t\t\tfor (size_t i = 0; i < available; i++) {\n";
+    out << "\t\t\t\t\t\tresponse.append(static_cast<Json::UInt>(src[i]));\n";
+    out << "\t\t\t\t\t}\n";
+    out << "\t\t\t\t}\n";
+    out << "\t\t\t\tfor (size_t i = available; i < size; i++) {\n";
+    out << "\t\t\t\t\tresponse.append(0u);\n";
+    out << "\t\t\t\t}\n";
+    out << "\t\t\t}\n";
     out << "\t\t\tstd::string responseStr = Json::writeString(Json::StreamWriterBuilder(), "
            "response);\n";
     out << "\t\t\tsocket.send(zmq::message_t(responseStr.c_str(), responseStr.size()), "
@@ -59,6 +59,20 @@ void Kernel::addRegister(Register r) { this->registers.emplace_back(r); }
 
 std::vector<Register> Kernel::getRegisters() { return this->registers; }
 
+void Kernel::addArgumentInterface(const std::string& argument, const std::string& interfaceName) {
+    this->argumentInterfaces[argument] = interfaceName;
+}
+
+std::vector<std::string> Kernel::getArgumentsOfInterface(const std::string& interfaceName) {
+    std::vector<std::string> arguments;
+    for (auto& [argument, intf] : argumentInterfaces) {
+        if (intf == interfaceName) {
+            arguments.push_back(argument);
+        }
+    }
+    return arguments;
+}
+
 void Kernel::setName(const std::string& instName) { this->name = instName; }
 std::string Kernel::getName() { return name; }
 
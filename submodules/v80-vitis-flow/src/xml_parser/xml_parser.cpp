@@ -161,6 +161,20 @@ void XmlParser::parseXml() {
                     xmlFree(value);
                 }
                 kernel.addInterface(intf);
+            } else if (nodeNameStr == XML_NODE_HW_REF) {
+                // <Arg ArgName="..."><hwRefs><hwRef type="interface" interface="m_axi_..."/>
+                xmlNodePtr argNode = current_node->parent ? current_node->parent->parent : nullptr;
+                xmlChar* type = xmlGetProp(current_node, BAD_CAST XML_ATTR_TYPE);
+                if (argNode && convertFromXmlCharPtr(argNode->name) == XML_NODE_ARG &&
+                    convertFromXmlCharPtr(type) == "interface") {
+                    xmlChar* argName = xmlGetProp(argNode, BAD_CAST XML_ATTR_ARG_NAME);
+                    xmlChar* intfName = xmlGetProp(current_node, BAD_CAST XML_ATTR_HW_REF_INTF);
+                    kernel.addArgumentInterface(convertFromXmlCharPtr(argName),
+                                                convertFromXmlCharPtr(intfName));
+                    xmlFree(argName);
+                    xmlFree(intfName);
+                }
+                xmlFree(type);
             }
             xmlFree(content);
         }
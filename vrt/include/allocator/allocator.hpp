@@ -22,10 +22,20 @@
 #define ALLOCATOR_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <vector>
+
+#include "allocator/memory_stats.hpp"
+#include "allocator/range_allocator.hpp"
+
 namespace vrt {
 
 /**
@@ -48,8 +58,54 @@ constexpr uint64_t DDR_START = 0x60000000000;
 /// Size of DDR (32 GB)
 constexpr uint64_t DDR_SIZE = 32L * 1024 * 1024 * 1024;  // 32G
 
+/// Alignment of blocks served directly from a memory range (4 KiB)
+constexpr uint64_t LARGE_BLOCK_ALIGNMENT = 4096;
+/// Smallest size class of the superblocks, one 512 bit AXI beat
+constexpr uint64_t SLAB_MIN_BLOCK_SIZE = 64;
+/// Maximum number of free blocks a thread caches per size class
+constexpr std::size_t THREAD_CACHE_BLOCKS = 32;
+/// Number of blocks fetched into a thread cache at once
+constexpr std::size_t THREAD_CACHE_REFILL = 8;
+/// Width of a 512 bit AXI beat in bytes
+constexpr uint64_t AXI_BEAT_SIZE = 64;
+/// Default alignment of device allocations, the AXI burst boundary (4 KiB)
+constexpr uint64_t DEFAULT_ALLOCATION_ALIGNMENT = 4096;
+/// Alignment of a huge page (2 MiB)
+constexpr uint64_t HUGE_PAGE_ALIGNMENT = 2 * 1024 * 1024;
+
+/**
+ * @brief Struct describing how a device allocation is placed.
+ *
+ * AXI masters split bursts at 4 KiB boundaries, so buffers should start on one. Blocks of at
+ * least `alignment` bytes start on an alignment boundary; smaller blocks start on an AXI beat
+ * boundary and never cross an alignment boundary, so small buffers do not waste a whole page.
+ */
+struct AllocationPolicy {
+    uint64_t alignment = DEFAULT_ALLOCATION_ALIGNMENT;  ///< Alignment, a power of two
+    bool padToAxiBeat = false;                          ///< Round the size up to whole AXI beats
+
+    /**
+     * @brief Gets the alignment a block of the given size needs under this policy.
+     * @param size The size of the block in bytes.
+     * @return The required alignment, a power of two.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    uint64_t alignmentFor(uint64_t size) const;
+
+    /**
+     * @brief Gets the size of a block after padding.
+     * @param size The requested size in bytes.
+     * @return The size to allocate, at least one byte.
+     */
+    uint64_t paddedSize(uint64_t size) const;
+};
+
 /**
  * @brief Class representing a superblock of memory.
+ *
+ * A superblock is a slab of equally sized blocks of one size class. Occupancy is kept in a
+ * bitmap, one bit per block. Blocks held by a thread cache stay occupied and are marked in a
+ * second, atomic bitmap, which thread caches update without the allocator lock.
  */
 class Superblock {
    public:
@@ -57,82 +113,171 @@ class Superblock {
      * @brief Constructor for Superblock.
      * @param startAddress The starting address of the superblock.
      * @param size The size of the superblock.
+     * @param blockSize The size of the blocks, the size class of the superblock.
      */
-    Superblock(uint64_t startAddress, uint64_t size);
+    Superblock(uint64_t startAddress, uint64_t size, uint64_t blockSize);
 
     /**
      * @brief Allocates a block of memory from the superblock.
-     * @param size The size of the memory block to allocate.
      * @return The starting address of the allocated memory block.
+     * @throws std::bad_alloc If the superblock is full.
      */
-    uint64_t allocate(uint64_t size);
+    uint64_t allocate();
 
     /**
      * @brief Deallocates a block of memory.
      * @param addr The starting address of the memory block to deallocate.
+     * @throws std::invalid_argument If the address is not an allocated block.
      */
     void deallocate(uint64_t addr);
 
+    /**
+     * @brief Checks if no block is allocated.
+     * @return True if the superblock is empty.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Checks if an address is an allocated block of the superblock.
+     * @param addr The address to check.
+     * @return True if the address is the start of an allocated block.
+     */
+    bool isAllocated(uint64_t addr) const;
+
+    /**
+     * @brief Marks an allocated block as held by a thread cache.
+     * @param addr The starting address of the block.
+     * @return False if the block was already marked, that is freed twice.
+     */
+    bool markCached(uint64_t addr);
+
+    /**
+     * @brief Clears the cache mark of a block that is handed out again.
+     * @param addr The starting address of the block.
+     */
+    void clearCached(uint64_t addr);
+
+    /**
+     * @brief Checks if every block is allocated.
+     * @return True if the superblock is full.
+     */
+    bool isFull() const;
+
+    /**
+     * @brief Gets the size of the blocks.
+     * @return The block size in bytes.
+     */
+    uint64_t getBlockSize() const;
+
+    /**
+     * @brief Gets the number of allocated blocks.
+     * @return The number of allocated blocks.
+     */
+    std::size_t getUsedCount() const;
+
     uint64_t startAddress;  ///< The starting address of the superblock.
    private:
-    uint64_t size;                   ///< The size of the superblock.
-    uint64_t offset;                 ///< The current offset for allocation.
-    std::vector<uint64_t> freeList;  ///< List of free memory blocks.
+    uint64_t size;                    ///< The size of the superblock.
+    uint64_t blockSize;               ///< The size of the blocks.
+    std::size_t blockCount;           ///< The number of blocks.
+    std::size_t usedCount = 0;        ///< The number of allocated blocks.
+    std::size_t searchHint = 0;       ///< The first bitmap word that may have a free bit.
+    std::vector<uint64_t> occupancy;  ///< Occupancy bitmap, a set bit marks a used block.
+    std::unique_ptr<std::atomic<uint64_t>[]>
+        cached;  ///< Cache bitmap, a set bit marks a block held by a thread cache.
 };
 
 /**
  * @brief Struct representing a range of memory.
  */
 struct MemoryRange {
-    uint64_t startAddress;                ///< The starting address of the memory range.
-    uint64_t size;                        ///< The size of the memory range.
-    uint64_t offset;                      ///< The current offset for allocation.
-    std::vector<Superblock> superblocks;  ///< List of superblocks in the memory range.
-    std::vector<uint64_t> freeList;       ///< List of free memory blocks.
-    std::vector<std::pair<uint64_t, uint64_t>> usedMemoryBlocks;  ///< List of used memory blocks.
+    MemoryRangeType type;                            ///< The type of the memory range.
+    uint64_t startAddress;                           ///< The starting address of the memory range.
+    uint64_t size;                                   ///< The size of the memory range.
+    std::vector<std::list<Superblock>> sizeClasses;  ///< Superblocks per size class.
+    RangeAllocator blocks;  ///< Large blocks and the memory of the superblocks.
     /**
      * @brief Constructor for MemoryRange.
+     * @param type The type of the memory range.
      * @param startAddress The starting address of the memory range.
      * @param size The size of the memory range.
+     * @param granularity The smallest unit of allocation of the range, a power of two.
      */
-    MemoryRange(uint64_t startAddress, uint64_t size);
+    MemoryRange(MemoryRangeType type, uint64_t startAddress, uint64_t size,
+                uint64_t granularity);
 };
 
 /**
  * @brief Class representing a memory allocator.
+ *
+ * The allocator is thread-safe. Small blocks are handed out from per-thread caches without
+ * locking, which are refilled and trimmed in batches under the allocator lock. Large blocks
+ * and port-pinned requests always take the lock.
  */
 class Allocator {
    public:
     /**
      * @brief Constructor for Allocator.
-     * @param superblockSize The size of the superblocks to use.
+     *
+     * Requests below half a superblock are served from superblocks of power-of-two size
+     * classes, larger ones directly from the memory range.
+     *
+     * @param superblockSize The size of the superblocks to use, a power of two.
+     * @throws std::invalid_argument If the superblock size is not a power of two.
      */
     Allocator(uint64_t superblockSize = 4096);
 
     Allocator() : Allocator(4096) {}
 
+    /**
+     * @brief Destructor for Allocator. Removes the shared statistics segment, if any.
+     */
+    ~Allocator();
+
+    Allocator(const Allocator&) = delete;
+    Allocator& operator=(const Allocator&) = delete;
+
     /**
      * @brief Adds a memory range to the allocator.
      * @param type The type of memory range (HBM or DDR).
      * @param startAddress The starting address of the memory range.
      * @param size The size of the memory range.
+     * @throws std::invalid_argument If the start address or size is not a multiple of the
+     * smaller of the superblock size and LARGE_BLOCK_ALIGNMENT.
      */
     void addMemoryRange(MemoryRangeType type, uint64_t startAddress, uint64_t size);
 
     /**
-     * @brief Allocates a block of memory.
+     * @brief Allocates a block of memory with the default policy.
      * @param size The size of the memory block to allocate.
      * @param type The type of memory range to allocate from (HBM or DDR).
      * @return The starting address of the allocated memory block.
      */
     uint64_t allocate(uint64_t size, MemoryRangeType type);
 
+    /**
+     * @brief Allocates a block of memory.
+     * @param size The size of the memory block to allocate.
+     * @param type The type of memory range to allocate from (HBM or DDR).
+     * @param policy The alignment and padding of the block.
+     * @return The starting address of the allocated memory block.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    uint64_t allocate(uint64_t size, MemoryRangeType type, const AllocationPolicy& policy);
+
     /**
      * @brief Deallocates a block of memory.
      * @param addr The starting address of the memory block to deallocate.
+     * @throws std::invalid_argument If the address lies in a superblock but is not an
+     * allocated block, including a block that was already freed.
      */
     void deallocate(uint64_t addr);
 
+    /**
+     * @brief Returns the small blocks cached by the calling thread to the superblocks.
+     */
+    void flushThreadCache();
+
     /**
      * @brief Allocates a block of memory from the specified port.
      * @param size The size of the memory block to allocate.
@@ -142,6 +287,34 @@ class Allocator {
      */
     uint64_t allocate(uint64_t size, MemoryRangeType type, uint8_t port);
 
+    /**
+     * @brief Allocates a block of memory from the specified port.
+     * @param size The size of the memory block to allocate.
+     * @param type The type of memory range to allocate from (HBM or DDR).
+     * @param port The port to allocate from.
+     * @param policy The alignment and padding of the block.
+     * @return The starting address of the allocated memory block.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    uint64_t allocate(uint64_t size, MemoryRangeType type, uint8_t port,
+                      const AllocationPolicy& policy);
+
+    /**
+     * @brief Sets the policy used by allocations that do not pass one.
+     *
+     * Must not run concurrently with allocations.
+     *
+     * @param policy The new default policy.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    void setDefaultPolicy(const AllocationPolicy& policy);
+
+    /**
+     * @brief Gets the policy used by allocations that do not pass one.
+     * @return The default policy, 4 KiB alignment without padding unless changed.
+     */
+    const AllocationPolicy& getDefaultPolicy() const;
+
     /**
      * @brief Gets the size of the specified memory range type.
      * @param type The type of memory range (HBM or DDR).
@@ -149,12 +322,212 @@ class Allocator {
      */
     uint64_t getSize(MemoryRangeType type) const;
 
+    /**
+     * @brief Gets a snapshot of the allocation statistics.
+     *
+     * Free bytes and the largest free block refer to the memory range itself; free blocks
+     * inside superblocks and thread caches count as used.
+     *
+     * @return The statistics of all memory ranges and HBM ports.
+     */
+    MemoryStats getStats() const;
+
+    /**
+     * @brief Moves the statistics counters into a POSIX shared memory segment.
+     *
+     * Other processes, such as v80-smi, can then read them while the application runs. The
+     * current counter values are carried over, including updates made while switching.
+     *
+     * @param name The name of the shared memory segment.
+     * @throws std::runtime_error If the segment cannot be created.
+     */
+    void shareStats(const std::string& name);
+
+    /**
+     * @brief Moves the statistics counters back into process memory and removes the segment.
+     *
+     * The segment is unmapped only once no thread updates it anymore.
+     */
+    void unshareStats();
+
    private:
+    /**
+     * @brief Class pinning the counters in use while the calling thread accesses them.
+     *
+     * The counters can move between process memory and a shared segment at any time; a block
+     * is only switched away from, merged and unmapped once no guard holds it.
+     */
+    class StatsGuard {
+       public:
+        /**
+         * @brief Constructor for StatsGuard. Pins the current counters.
+         * @param allocator The allocator owning the counters.
+         */
+        explicit StatsGuard(const Allocator& allocator);
+
+        /**
+         * @brief Destructor for StatsGuard. Releases the counters.
+         */
+        ~StatsGuard();
+
+        StatsGuard(const StatsGuard&) = delete;
+        StatsGuard& operator=(const StatsGuard&) = delete;
+
+        /**
+         * @brief Accesses the pinned counters.
+         * @return The counters.
+         */
+        MemoryStatsBlock* operator->() const;
+
+       private:
+        const Allocator& allocator;  ///< The allocator owning the counters.
+        uint32_t epoch;              ///< The epoch the guard is counted in.
+        MemoryStatsBlock* block;     ///< The pinned counters.
+    };
+
+    /**
+     * @brief Struct locating a superblock inside its memory range.
+     */
+    struct SuperblockRef {
+        MemoryRange* range;                          ///< The memory range of the superblock.
+        std::size_t sizeClass;                       ///< The size class of the superblock.
+        std::list<Superblock>::iterator superblock;  ///< The superblock.
+    };
+
+    /**
+     * @brief Struct describing a free small block held by a thread cache.
+     *
+     * The superblock cannot be released while one of its blocks is cached, so the pointer
+     * stays valid until the block leaves the cache.
+     */
+    struct CachedBlock {
+        uint64_t addr;           ///< The starting address of the block.
+        Superblock* superblock;  ///< The superblock holding the block.
+    };
+
+    /**
+     * @brief Struct holding the free small blocks cached by one thread.
+     *
+     * Only the owning thread touches the block lists. A cache whose thread has exited is
+     * marked orphaned and drained by the allocator under its lock.
+     */
+    struct ThreadCache {
+        std::unordered_map<uint32_t, std::vector<CachedBlock>>
+            freeBlocks;                     ///< Free blocks by memory range type and size class.
+        std::atomic<bool> orphaned{false};  ///< Set when the owning thread has exited.
+    };
+
+    /**
+     * @brief Allocates a small block from the superblocks of its size class.
+     *
+     * Superblocks with free blocks are kept at the front of their class list, so the common
+     * case takes the first one.
+     *
+     * @param range The memory range to allocate from.
+     * @param size The size of the block.
+     * @param minAddress The lowest address of a new superblock.
+     * @param maxAddress The end of the window superblocks are reused from.
+     * @return The starting address of the allocated block.
+     */
+    uint64_t allocateSmall(MemoryRange& range, uint64_t size, uint64_t minAddress,
+                           uint64_t maxAddress);
+
+    /**
+     * @brief Returns a small block to its superblock, releasing the superblock when empty.
+     * @param ref The superblock holding the block.
+     * @param addr The starting address of the block.
+     */
+    void deallocateSmall(const SuperblockRef& ref, uint64_t addr);
+
+    /**
+     * @brief Gets the cache of the calling thread, registering it on first use.
+     * @return The thread cache.
+     */
+    ThreadCache& getThreadCache();
+
+    /**
+     * @brief Returns the blocks of caches whose thread has exited. Requires the lock.
+     */
+    void drainOrphanedCaches();
+
+    /**
+     * @brief Allocates a block and records it in the statistics.
+     * @param size The size of the block.
+     * @param type The type of memory range.
+     * @param port The HBM port to allocate from, or -1 for any.
+     * @param policy The alignment and padding of the block.
+     * @return The starting address of the allocated block.
+     */
+    uint64_t allocateTracked(uint64_t size, MemoryRangeType type, int port,
+                             const AllocationPolicy& policy);
+
+    /**
+     * @brief Allocates a block.
+     * @param size The size of the block.
+     * @param type The type of memory range.
+     * @param port The HBM port to allocate from, or -1 for any.
+     * @param alignment The alignment of blocks served from the range itself.
+     * @param blockSize Set to the number of bytes claimed by the block.
+     * @return The starting address of the allocated block.
+     */
+    uint64_t allocateBlock(uint64_t size, MemoryRangeType type, int port, uint64_t alignment,
+                           uint64_t& blockSize);
+
+    /**
+     * @brief Adds or removes a block in the bytes in use of its range and HBM ports.
+     * @param type The type of memory range.
+     * @param addr The starting address of the block.
+     * @param bytes The number of bytes claimed by the block.
+     * @param add True to add the block, false to remove it.
+     */
+    void accountBlock(MemoryRangeType type, uint64_t addr, uint64_t bytes, bool add);
+
+    /**
+     * @brief Points the counters at another block. Requires the lock.
+     *
+     * The current values are copied over first. Updates that threads still make to the old
+     * block are merged in after they finished, so the old block can be released afterwards.
+     *
+     * @param next The block to use from now on.
+     * @return The block used before.
+     */
+    MemoryStatsBlock* switchStats(MemoryStatsBlock* next);
+
+    /**
+     * @brief Refreshes the free space counters of a range. Requires the lock.
+     * @param range The memory range.
+     */
+    void updateFreeStats(const MemoryRange& range);
+
+    /**
+     * @brief Gets the key of a size class in the thread caches.
+     * @param type The type of the memory range.
+     * @param sizeClass The size class.
+     * @return The cache key.
+     */
+    static uint32_t cacheKey(MemoryRangeType type, std::size_t sizeClass);
+
+    /**
+     * @brief Gets the size class of a request.
+     * @param size The size of the request.
+     * @return The index of the smallest class holding the request.
+     */
+    static std::size_t sizeClassOf(uint64_t size);
+
     uint64_t superblockSize;  ///< The size of the superblocks.
     std::unordered_map<MemoryRangeType, MemoryRange>
         memoryRanges;  ///< Map of memory ranges by type.
-    std::unordered_map<uint64_t, Superblock*>
-        addrToSuperblock;  ///< Map of addresses to superblocks.
+    std::unordered_map<uint64_t, SuperblockRef>
+        superblockIndex;  ///< Map of superblock start addresses to superblocks.
+    std::vector<std::shared_ptr<ThreadCache>> threadCaches;  ///< Caches of all threads.
+    uint64_t id;                      ///< Unique id keying the thread caches of this allocator.
+    mutable std::shared_mutex mutex;  ///< Guards all state except the thread caches.
+    std::unique_ptr<MemoryStatsBlock> localStats;  ///< Counters while not shared
+    std::atomic<MemoryStatsBlock*> stats;          ///< Counters in use, local or shared
+    std::atomic<uint32_t> statsEpoch{0};           ///< Epoch new StatsGuards are counted in
+    mutable std::atomic<uint32_t> statsUsers[2] = {};  ///< Live StatsGuards per epoch
+    std::string sharedStatsName;                   ///< Name of the shared segment, if any
+    AllocationPolicy defaultPolicy;                ///< Policy of allocations without one
 };
 
 }  // namespace vrt
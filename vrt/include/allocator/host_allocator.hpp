@@ -0,0 +1,151 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef HOST_ALLOCATOR_HPP
+#define HOST_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace vrt {
+
+/// Size of a regular host page (4 KiB)
+constexpr std::size_t HOST_PAGE_SIZE = 4096;
+/// Size of a huge host page (2 MiB)
+constexpr std::size_t HOST_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * @brief Class managing the host memory backing buffer shadows.
+ *
+ * Memory is mapped directly from the kernel, so every block starts on a page boundary. Blocks
+ * can be backed by 2 MiB huge pages, bound to the NUMA node of the device and locked in RAM.
+ * Released blocks are kept in a pool and handed out again for requests of a similar size.
+ */
+class HostAllocator {
+   public:
+    /// Default upper bound of the bytes kept in the pool (1 GiB)
+    static constexpr std::size_t DEFAULT_POOL_LIMIT = 1UL << 30;
+
+    /**
+     * @brief Constructor for HostAllocator.
+     * @param numaNode The NUMA node to bind memory to, or -1 for no binding.
+     */
+    explicit HostAllocator(int numaNode = -1);
+
+    /**
+     * @brief Destructor for HostAllocator. Unmaps the pooled blocks.
+     */
+    ~HostAllocator();
+
+    /**
+     * @brief Allocates a block of host memory.
+     * @param size The size of the block in bytes.
+     * @return A page-aligned pointer to the block.
+     * @throws std::bad_alloc If the memory cannot be mapped.
+     */
+    void* allocate(std::size_t size);
+
+    /**
+     * @brief Releases a block obtained from allocate().
+     * @param ptr The pointer to the block. Null pointers are ignored.
+     */
+    void deallocate(void* ptr);
+
+    /**
+     * @brief Sets the NUMA node new blocks are bound to. Pooled blocks are released.
+     * @param numaNode The NUMA node, or -1 for no binding.
+     */
+    void setNumaNode(int numaNode);
+
+    /**
+     * @brief Gets the NUMA node new blocks are bound to.
+     * @return The NUMA node, or -1 if memory is not bound.
+     */
+    int getNumaNode() const;
+
+    /**
+     * @brief Enables or disables 2 MiB huge pages for new blocks. Pooled blocks are released.
+     *
+     * Reserved huge pages are used when available, otherwise the block is 2 MiB aligned and
+     * advised for transparent huge pages.
+     *
+     * @param enable Flag indicating whether to use huge pages.
+     */
+    void setHugePages(bool enable);
+
+    /**
+     * @brief Enables or disables locking new blocks in RAM. Pooled blocks are released.
+     * @param enable Flag indicating whether to lock blocks.
+     */
+    void setLockPages(bool enable);
+
+    /**
+     * @brief Sets the maximum number of bytes kept in the pool.
+     * @param limit The pool limit in bytes. Zero disables pooling.
+     */
+    void setPoolLimit(std::size_t limit);
+
+    /**
+     * @brief Unmaps all pooled blocks.
+     */
+    void trim();
+
+    HostAllocator(const HostAllocator&) = delete;
+    HostAllocator& operator=(const HostAllocator&) = delete;
+
+   private:
+    /**
+     * @brief Maps a new block from the kernel.
+     * @param size The size of the block in bytes, a multiple of the page size.
+     * @return A pointer to the block.
+     */
+    void* mapBlock(std::size_t size);
+
+    /**
+     * @brief Unmaps all pooled blocks. The caller must hold the mutex.
+     */
+    void releasePool();
+
+    /**
+     * @brief Binds a freshly mapped block to the configured NUMA node.
+     * @param ptr The pointer to the block.
+     * @param size The size of the block in bytes.
+     */
+    void bindBlock(void* ptr, std::size_t size);
+
+    int numaNode;                                   ///< NUMA node to bind to, -1 for none
+    bool hugePages = false;                         ///< Flag indicating huge page backing
+    bool lockPages = false;                         ///< Flag indicating locked blocks
+    std::size_t poolLimit = DEFAULT_POOL_LIMIT;     ///< Maximum bytes kept in the pool
+    std::size_t pooledBytes = 0;                    ///< Bytes currently kept in the pool
+    std::multimap<std::size_t, void*> pool;         ///< Released blocks by size
+    std::unordered_map<void*, std::size_t> blocks;  ///< Live blocks and their mapped size
+    std::mutex mutex;                               ///< Guards the allocator state
+};
+
+}  // namespace vrt
+
+#endif  // HOST_ALLOCATOR_HPP
@@ -0,0 +1,104 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef MEMORY_STATS_HPP
+#define MEMORY_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vrt {
+
+/// Magic number at the start of a shared memory statistics segment ("VRTM")
+constexpr uint32_t MEMORY_STATS_MAGIC = 0x5652544D;
+/// Layout version of the shared memory statistics segment
+constexpr uint32_t MEMORY_STATS_VERSION = 1;
+/// Number of HBM ports tracked in the statistics
+constexpr std::size_t MEMORY_STATS_PORTS = 32;
+/// Number of memory range types tracked in the statistics
+constexpr std::size_t MEMORY_STATS_RANGES = 2;
+/// Name of the shared memory statistics segment, formatted with the PCIe bus of the device
+#define MEMORY_STATS_SHM_NAME "/vrt_memstat_%s"
+
+/**
+ * @brief Struct holding the live counters of one memory range.
+ *
+ * The counters are updated lock-free by the allocator and may live in a shared memory segment,
+ * so v80-smi can read them while the application runs. The layout is shared with v80-smi and
+ * must only change together with MEMORY_STATS_VERSION.
+ */
+struct MemoryRangeCounters {
+    std::atomic<uint64_t> size;               ///< Size of the range in bytes
+    std::atomic<uint64_t> bytesInUse;         ///< Bytes handed out to the application
+    std::atomic<uint64_t> peakBytesInUse;     ///< High-water mark of bytesInUse
+    std::atomic<uint64_t> freeBytes;          ///< Bytes not claimed by blocks or superblocks
+    std::atomic<uint64_t> largestFreeBlock;   ///< Largest contiguous free block in bytes
+    std::atomic<uint64_t> allocations;        ///< Number of successful allocations
+    std::atomic<uint64_t> deallocations;      ///< Number of deallocations
+    std::atomic<uint64_t> failedAllocations;  ///< Number of allocations that threw
+    std::atomic<uint64_t> allocationNs;       ///< Total time spent in allocate in nanoseconds
+    std::atomic<uint64_t> maxAllocationNs;    ///< Slowest allocation in nanoseconds
+};
+
+/**
+ * @brief Struct holding all counters of an allocator, as laid out in shared memory.
+ */
+struct MemoryStatsBlock {
+    uint32_t magic;                                            ///< MEMORY_STATS_MAGIC when valid
+    uint32_t version;                                          ///< MEMORY_STATS_VERSION of writer
+    int32_t pid;                                               ///< Process id of the writer
+    uint32_t reserved;                                         ///< Padding
+    MemoryRangeCounters ranges[MEMORY_STATS_RANGES];           ///< Counters by MemoryRangeType
+    std::atomic<uint64_t> portBytesInUse[MEMORY_STATS_PORTS];  ///< Bytes in use per HBM port
+    std::atomic<uint64_t> portPeakBytes[MEMORY_STATS_PORTS];   ///< Peak bytes per HBM port
+};
+
+/**
+ * @brief Struct representing a snapshot of the statistics of one memory range.
+ */
+struct MemoryRangeStats {
+    uint64_t size = 0;               ///< Size of the range in bytes
+    uint64_t bytesInUse = 0;         ///< Bytes handed out to the application
+    uint64_t peakBytesInUse = 0;     ///< High-water mark of bytesInUse
+    uint64_t freeBytes = 0;          ///< Bytes not claimed by blocks or superblocks
+    uint64_t largestFreeBlock = 0;   ///< Largest contiguous free block in bytes
+    double fragmentation = 0.0;      ///< 1 - largestFreeBlock / freeBytes, 0 when unfragmented
+    uint64_t allocations = 0;        ///< Number of successful allocations
+    uint64_t deallocations = 0;      ///< Number of deallocations
+    uint64_t failedAllocations = 0;  ///< Number of allocations that threw
+    double averageAllocationNs = 0;  ///< Mean allocation latency in nanoseconds
+    uint64_t maxAllocationNs = 0;    ///< Slowest allocation in nanoseconds
+};
+
+/**
+ * @brief Struct representing a snapshot of the device memory statistics.
+ */
+struct MemoryStats {
+    MemoryRangeStats hbm;                                     ///< HBM statistics
+    MemoryRangeStats ddr;                                     ///< DDR statistics
+    std::array<uint64_t, MEMORY_STATS_PORTS> portBytesInUse;  ///< Bytes in use per HBM port
+    std::array<uint64_t, MEMORY_STATS_PORTS> portPeakBytes;   ///< Peak bytes per HBM port
+};
+
+}  // namespace vrt
+
+#endif  // MEMORY_STATS_HPP
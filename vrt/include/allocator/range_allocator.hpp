@@ -0,0 +1,213 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef RANGE_ALLOCATOR_HPP
+#define RANGE_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace vrt {
+
+/**
+ * @brief Class managing the blocks of a contiguous address range.
+ *
+ * Blocks are multiples of a granularity, so every free block starts on a granule. Free space
+ * is kept in an ordered map by address, an ordered set by size and a tree by address that
+ * knows the largest free block of each subtree. Freeing merges a block with its free
+ * neighbours in O(log n) of the number of free blocks. Allocations aligned to at most the
+ * granularity take O(log n) as well, since any free block of the requested size fits them.
+ * Larger alignments additionally try the free blocks that are less than one alignment larger
+ * than the request, which only fit when their start happens to be aligned.
+ */
+class RangeAllocator {
+   public:
+    /**
+     * @brief Constructor for RangeAllocator.
+     * @param startAddress The first address of the range, a multiple of the granularity.
+     * @param size The size of the range in bytes, a multiple of the granularity.
+     * @param granularity The smallest unit of allocation, a power of two.
+     * @throws std::invalid_argument If the granularity is not a power of two or does not
+     * divide the start address and size.
+     */
+    RangeAllocator(uint64_t startAddress, uint64_t size, uint64_t granularity = 1);
+
+    /**
+     * @brief Allocates a block using best fit.
+     * @param size The size of the block in bytes, rounded up to the granularity.
+     * @param alignment The alignment of the block, a power of two.
+     * @return The address of the block.
+     * @throws std::bad_alloc If no free block fits.
+     */
+    uint64_t allocate(uint64_t size, uint64_t alignment);
+
+    /**
+     * @brief Allocates the lowest fitting block at or above an address.
+     *
+     * Used to place blocks close to a given address, such as the start of an HBM port. The
+     * address tree finds the lowest free block of sufficient size in O(log n).
+     *
+     * @param size The size of the block in bytes, rounded up to the granularity.
+     * @param alignment The alignment of the block, a power of two.
+     * @param minAddress The lowest address the block may start at.
+     * @return The address of the block.
+     * @throws std::bad_alloc If no free block fits.
+     */
+    uint64_t allocateFrom(uint64_t size, uint64_t alignment, uint64_t minAddress);
+
+    /**
+     * @brief Frees a block and merges it with its free neighbours.
+     * @param addr The address returned by allocate().
+     * @return True if the address was an allocated block.
+     */
+    bool deallocate(uint64_t addr);
+
+    /**
+     * @brief Checks if an address lies inside the range.
+     * @param addr The address to check.
+     * @return True if the address is inside the range.
+     */
+    bool contains(uint64_t addr) const;
+
+    /**
+     * @brief Gets the size of an allocated block.
+     * @param addr The address of the block.
+     * @return The size of the block in bytes, 0 if the address is not allocated.
+     */
+    uint64_t getBlockSize(uint64_t addr) const;
+
+    /**
+     * @brief Gets the number of free bytes.
+     * @return The free bytes.
+     */
+    uint64_t getFreeBytes() const;
+
+    /**
+     * @brief Gets the size of the largest free block.
+     * @return The size of the largest free block in bytes.
+     */
+    uint64_t getLargestFreeBlock() const;
+
+    /**
+     * @brief Gets the number of free blocks.
+     * @return The number of free blocks.
+     */
+    std::size_t getFreeBlockCount() const;
+
+    /**
+     * @brief Gets the number of allocated blocks.
+     * @return The number of allocated blocks.
+     */
+    std::size_t getUsedBlockCount() const;
+
+   private:
+    /**
+     * @brief Struct representing a free block in the address tree.
+     *
+     * The tree is a treap: ordered by address, heap-ordered by a random priority.
+     */
+    struct FreeNode {
+        uint64_t addr;                    ///< Address of the free block
+        uint64_t size;                    ///< Size of the free block
+        uint64_t maxSize;                 ///< Largest free block in the subtree
+        uint32_t priority;                ///< Random heap priority
+        std::unique_ptr<FreeNode> left;   ///< Subtree of lower addresses
+        std::unique_ptr<FreeNode> right;  ///< Subtree of higher addresses
+    };
+
+    /**
+     * @brief Finds the lowest free block at or above an address of at least a given size.
+     * @param node The subtree to search.
+     * @param minAddress The lowest address of the block.
+     * @param minSize The smallest size of the block.
+     * @return The block, or nullptr if the subtree holds none.
+     */
+    static const FreeNode* findFirstFit(const FreeNode* node, uint64_t minAddress,
+                                        uint64_t minSize);
+
+    /**
+     * @brief Splits a subtree into the blocks below an address and the rest.
+     * @param node The subtree to split.
+     * @param addr The address to split at.
+     * @param lower Set to the blocks below the address.
+     * @param upper Set to the blocks at or above the address.
+     */
+    static void split(std::unique_ptr<FreeNode> node, uint64_t addr,
+                      std::unique_ptr<FreeNode>& lower, std::unique_ptr<FreeNode>& upper);
+
+    /**
+     * @brief Joins two subtrees whose blocks are ordered by address.
+     * @param lower The subtree of lower addresses.
+     * @param upper The subtree of higher addresses.
+     * @return The joined subtree.
+     */
+    static std::unique_ptr<FreeNode> merge(std::unique_ptr<FreeNode> lower,
+                                           std::unique_ptr<FreeNode> upper);
+
+    /**
+     * @brief Recomputes the largest free block of a subtree from its children.
+     * @param node The root of the subtree.
+     */
+    static void updateMaxSize(FreeNode& node);
+
+    /**
+     * @brief Carves an aligned block out of a free block.
+     * @param freeIt The free block, by address.
+     * @param addr The aligned address of the new block.
+     * @param size The size of the new block.
+     * @return The address of the block.
+     */
+    uint64_t carve(std::map<uint64_t, uint64_t>::iterator freeIt, uint64_t addr, uint64_t size);
+
+    /**
+     * @brief Adds a free block to both indices.
+     * @param addr The address of the block.
+     * @param size The size of the block.
+     */
+    void insertFree(uint64_t addr, uint64_t size);
+
+    /**
+     * @brief Removes a free block from both indices.
+     * @param it The block, by address.
+     */
+    void eraseFree(std::map<uint64_t, uint64_t>::iterator it);
+
+    uint64_t startAddress;                               ///< First address of the range
+    uint64_t size;                                       ///< Size of the range in bytes
+    uint64_t granularity;                                ///< Smallest unit of allocation
+    uint64_t freeBytes;                                  ///< Sum of the free blocks
+    std::map<uint64_t, uint64_t> freeByAddress;          ///< Free blocks, address to size
+    std::set<std::pair<uint64_t, uint64_t>> freeBySize;  ///< Free blocks, (size, address)
+    std::unique_ptr<FreeNode> freeTree;                  ///< Free blocks, tree by address
+    std::minstd_rand random;                             ///< Priorities of the tree nodes
+    std::unordered_map<uint64_t, uint64_t> usedBlocks;   ///< Allocated blocks, address to size
+};
+
+}  // namespace vrt
+
+#endif  // RANGE_ALLOCATOR_HPP
@@ -0,0 +1,192 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "allocator/allocator.hpp"
+#include "api/device.hpp"
+
+namespace vrt {
+
+template <typename T>
+class Buffer;
+
+/**
+ * @brief Class representing a device memory arena.
+ *
+ * The arena reserves one device region up front and hands out pieces of it by bumping an
+ * offset, so allocations are O(1) and never touch the device allocator. Everything is released
+ * at once by reset(). This suits temporaries that are created and dropped every iteration of a
+ * loop; device memory use stays constant and the allocator does not fragment.
+ *
+ * Buffers are placed in an arena with the Buffer(Arena&, ...) constructor. Their destructor does
+ * not free anything; the arena only tracks how many of them are alive, and reset() requires
+ * all of them to be destroyed. For per-port placement create one arena per HBM port.
+ *
+ * The allocation policy applies to the region and to every allocation from it. It defaults to
+ * the policy of the device allocator.
+ */
+class Arena {
+   public:
+    /**
+     * @brief Constructor for Arena.
+     * @param device VRT Device of the arena.
+     * @param size The size of the arena in bytes.
+     * @param type The type of memory range.
+     */
+    Arena(Device device, uint64_t size, MemoryRangeType type);
+
+    /**
+     * @brief Constructor for Arena.
+     * @param device VRT Device of the arena.
+     * @param size The size of the arena in bytes.
+     * @param type The type of memory range.
+     * @param port The HBM port number. This would not have any effect if the type is DDR.
+     */
+    Arena(Device device, uint64_t size, MemoryRangeType type, uint8_t port);
+
+    /**
+     * @brief Constructor for Arena with an allocation policy.
+     * @param device VRT Device of the arena.
+     * @param size The size of the arena in bytes.
+     * @param type The type of memory range.
+     * @param policy The alignment and padding of the region and its allocations.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    Arena(Device device, uint64_t size, MemoryRangeType type, const AllocationPolicy& policy);
+
+    /**
+     * @brief Constructor for Arena on an HBM port with an allocation policy.
+     * @param device VRT Device of the arena.
+     * @param size The size of the arena in bytes.
+     * @param type The type of memory range.
+     * @param port The HBM port number. This would not have any effect if the type is DDR.
+     * @param policy The alignment and padding of the region and its allocations.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    Arena(Device device, uint64_t size, MemoryRangeType type, uint8_t port,
+          const AllocationPolicy& policy);
+
+    /**
+     * @brief Destructor for Arena. Returns the region to the device allocator.
+     */
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocates device memory from the arena with the policy of the arena.
+     * @param size The size in bytes.
+     * @return The physical address of the allocation.
+     * @throws std::bad_alloc If the arena has not enough space left.
+     */
+    uint64_t allocate(uint64_t size);
+
+    /**
+     * @brief Allocates device memory from the arena.
+     * @param size The size in bytes.
+     * @param policy The alignment and padding of the allocation.
+     * @return The physical address of the allocation.
+     * @throws std::bad_alloc If the arena has not enough space left.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    uint64_t allocate(uint64_t size, const AllocationPolicy& policy);
+
+    /**
+     * @brief Releases all allocations of the arena.
+     * @throws std::logic_error If buffers placed in the arena are still alive.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the physical address of the arena region.
+     * @return The physical address of the region.
+     */
+    uint64_t getBaseAddress() const;
+
+    /**
+     * @brief Gets the size of the arena.
+     * @return The size of the arena in bytes.
+     */
+    uint64_t getSize() const;
+
+    /**
+     * @brief Gets the number of bytes allocated since the last reset, including padding.
+     * @return The number of used bytes.
+     */
+    uint64_t getUsedBytes() const;
+
+    /**
+     * @brief Gets the high-water mark of the used bytes over all resets.
+     * @return The largest number of used bytes seen.
+     */
+    uint64_t getPeakBytes() const;
+
+    /**
+     * @brief Gets the device of the arena.
+     * @return The device.
+     */
+    Device getDevice() const;
+
+    /**
+     * @brief Gets the memory range type of the arena.
+     * @return The memory range type.
+     */
+    MemoryRangeType getType() const;
+
+    /**
+     * @brief Gets the allocation policy of the arena.
+     * @return The allocation policy.
+     */
+    const AllocationPolicy& getPolicy() const;
+
+   private:
+    template <typename T>
+    friend class Buffer;
+
+    /**
+     * @brief Registers a buffer placed in the arena.
+     */
+    void attach();
+
+    /**
+     * @brief Unregisters a buffer placed in the arena.
+     */
+    void detach();
+
+    Device device;                ///< The device of the arena
+    MemoryRangeType type;         ///< The type of memory range
+    AllocationPolicy policy;      ///< The policy of the region and its allocations
+    uint64_t baseAddress = 0;     ///< The physical address of the region
+    uint64_t size;                ///< The size of the region in bytes
+    uint64_t offset = 0;          ///< The first free byte of the region
+    uint64_t peak = 0;            ///< The largest offset seen
+    std::size_t liveBuffers = 0;  ///< The number of buffers placed in the arena and alive
+};
+
+}  // namespace vrt
+
+#endif  // ARENA_HPP
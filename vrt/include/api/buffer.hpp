@@ -21,22 +21,19 @@
 #ifndef BUFFER_HPP
 #define BUFFER_HPP
 
+#include <memory>
+
 #include "allocator/allocator.hpp"
+#include "api/arena.hpp"
+#include "api/buffer_base.hpp"
 #include "api/device.hpp"
+#include "api/sync_event.hpp"
 #include "qdma/qdma_intf.hpp"
 #include "utils/platform.hpp"
 #include "utils/zmq_server.hpp"
 
 namespace vrt {
 
-/**
- * @brief Enum class representing the type of synchronization.
- */
-enum class SyncType {
-    HOST_TO_DEVICE,  ///< Synchronize from host to device
-    DEVICE_TO_HOST,  ///< Synchronize from device to host
-};
-
 /**
  * @brief Class representing a buffer.
  *
@@ -46,7 +43,7 @@ enum class SyncType {
  * @tparam T The type of the elements in the buffer.
  */
 template <typename T>
-class Buffer {
+class Buffer : public BufferBase {
    public:
     /**
      * @brief Constructor for Buffer.
@@ -65,10 +62,118 @@ class Buffer {
      */
     Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port);
 
+    /**
+     * @brief Constructor for Buffer with memory flags.
+     *
+     * With MemoryFlags::DEVICE_ONLY only device memory is allocated. The host copy is created
+     * on the first access or synchronization, and emulation creates the buffer without sending
+     * any contents.
+     *
+     * @param device VRT Device of the buffer.
+     * @param size The size of the buffer.
+     * @param type The type of memory range.
+     * @param flags The memory flags.
+     */
+    Buffer(Device device, size_t size, MemoryRangeType type, MemoryFlags flags);
+
+    /**
+     * @brief Constructor for Buffer with memory flags.
+     * @param device VRT Device of the buffer.
+     * @param size The size of the buffer.
+     * @param type The type of memory range.
+     * @param port The HBM port number. This would not have any effect if the type is DDR.
+     * @param flags The memory flags.
+     */
+    Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port, MemoryFlags flags);
+
+    /**
+     * @brief Constructor for Buffer with an allocation policy.
+     *
+     * The other constructors use the default policy of the device allocator, 4 KiB alignment.
+     * Pass e.g. AllocationPolicy{HUGE_PAGE_ALIGNMENT} for 2 MiB alignment, or set padToAxiBeat
+     * so a kernel can read the last element as part of a full beat.
+     *
+     * @param device VRT Device of the buffer.
+     * @param size The size of the buffer.
+     * @param type The type of memory range.
+     * @param policy The alignment and padding of the device memory.
+     * @param flags The memory flags.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    Buffer(Device device, size_t size, MemoryRangeType type, const AllocationPolicy& policy,
+           MemoryFlags flags = MemoryFlags::NONE);
+
+    /**
+     * @brief Constructor for Buffer on an HBM port with an allocation policy.
+     * @param device VRT Device of the buffer.
+     * @param size The size of the buffer.
+     * @param type The type of memory range.
+     * @param port The HBM port number. This would not have any effect if the type is DDR.
+     * @param policy The alignment and padding of the device memory.
+     * @param flags The memory flags.
+     * @throws std::invalid_argument If the alignment is not a power of two.
+     */
+    Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port,
+           const AllocationPolicy& policy, MemoryFlags flags = MemoryFlags::NONE);
+
+    /**
+     * @brief Constructor for Buffer placed next to a kernel argument.
+     *
+     * The buffer is allocated on the HBM pseudo-channel the argument's AXI-MM interface is
+     * attached to, as recorded in the system map, so the kernel's accesses stay local.
+     *
+     * @param device VRT Device of the buffer.
+     * @param size The size of the buffer.
+     * @param kernel The kernel the buffer is passed to.
+     * @param argument The name of the kernel argument (or its AXI-MM interface).
+     * @param flags The memory flags.
+     * @throws std::out_of_range If the system map assigns no port to the argument, as in
+     *         segmented designs, where all interfaces share one NoC slave.
+     */
+    Buffer(Device device, size_t size, const Kernel& kernel, const std::string& argument,
+           MemoryFlags flags = MemoryFlags::NONE);
+
+    /**
+     * @brief Constructor for Buffer placed in an arena.
+     *
+     * The device memory is bump-allocated from the arena and given back by Arena::reset(), not
+     * by the destructor. The buffer must be destroyed before the arena is reset.
+     *
+     * @param arena The arena to place the buffer in.
+     * @param size The size of the buffer.
+     * @param flags The memory flags.
+     * @throws std::bad_alloc If the arena has not enough space left.
+     */
+    Buffer(Arena& arena, size_t size, MemoryFlags flags = MemoryFlags::NONE);
+
+    /**
+     * @brief Constructor for Buffer using caller-owned host memory.
+     *
+     * Transfers go directly from and into the given memory, no host copy is made. The memory
+     * must stay valid until the buffer is destroyed and every pending asynchronous
+     * synchronization has completed. It is not released by the buffer.
+     *
+     * @param device VRT Device of the buffer.
+     * @param hostPtr Pointer to the caller-owned host memory, holding at least size elements.
+     * @param size The size of the buffer.
+     * @param type The type of memory range.
+     */
+    Buffer(Device device, T* hostPtr, size_t size, MemoryRangeType type);
+
+    /**
+     * @brief Constructor for Buffer using caller-owned host memory.
+     * @param device VRT Device of the buffer.
+     * @param hostPtr Pointer to the caller-owned host memory, holding at least size elements.
+     * @param size The size of the buffer.
+     * @param type The type of memory range.
+     * @param port The HBM port number. This would not have any effect if the type is DDR.
+     */
+    Buffer(Device device, T* hostPtr, size_t size, MemoryRangeType type, uint8_t port);
+
     /**
      * @brief Destructor for Buffer.
      */
-    ~Buffer();
+    ~Buffer() override;
 
     /**
      * @brief Gets a pointer to the buffer.
@@ -78,6 +183,9 @@ class Buffer {
 
     /**
      * @brief Overloads the subscript operator to access buffer elements.
+     *
+     * When dirty tracking is enabled, the page holding the element is marked as modified.
+     *
      * @param index The index of the element to access.
      * @return A reference to the element at the specified index.
      */
@@ -94,7 +202,7 @@ class Buffer {
      * @brief Gets the physical address of the buffer.
      * @return The physical address of the buffer.
      */
-    uint64_t getPhysAddr() const;
+    uint64_t getPhysAddr() const override;
 
     /**
      * @brief Gets the lower 32 bits of the physical address of the buffer.
@@ -108,11 +216,149 @@ class Buffer {
      */
     uint32_t getPhysAddrHigh() const;
 
+    /**
+     * @brief Gets a mutable pointer to a range of elements.
+     *
+     * When dirty tracking is enabled, the whole range is marked as modified.
+     *
+     * @param offset The index of the first element.
+     * @param count The number of elements.
+     * @return A pointer to the first element of the range.
+     * @throws std::out_of_range If the range exceeds the buffer.
+     */
+    T* getSpan(size_t offset, size_t count);
+
     /**
      * @brief Synchronizes the buffer.
+     *
+     * With dirty tracking enabled, a host to device synchronization only transfers the pages
+     * modified since the last synchronization.
+     *
+     * @param syncType The type of synchronization.
+     */
+    void sync(SyncType syncType) override;
+
+    /**
+     * @brief Synchronizes a range of the buffer.
+     * @param syncType The type of synchronization.
+     * @param offset The index of the first element to synchronize.
+     * @param count The number of elements to synchronize.
+     * @throws std::out_of_range If the range exceeds the buffer.
+     */
+    void sync(SyncType syncType, size_t offset, size_t count);
+
+    /**
+     * @brief Synchronizes a strided 2D/3D region of the buffer.
+     *
+     * Every row of the region becomes one DMA segment. The segments are issued together, rows
+     * adjacent on host and device are merged, and nothing outside the region is transferred.
+     *
      * @param syncType The type of synchronization.
+     * @param rect The region, with host and device layout.
+     * @throws std::invalid_argument If a pitch is smaller than the region it has to hold.
+     * @throws std::out_of_range If the region exceeds the buffer.
      */
-    void sync(SyncType syncType);
+    void syncRect(SyncType syncType, const SyncRect& rect);
+
+    /**
+     * @brief Synchronizes a strided 2D/3D region with the same layout on host and device.
+     * @param syncType The type of synchronization.
+     * @param offset The index of the first element.
+     * @param width The number of elements per row.
+     * @param height The number of rows per slice.
+     * @param rowPitch The number of elements between rows.
+     * @param depth The number of slices.
+     * @param slicePitch The number of elements between slices, 0 for height rows.
+     */
+    void syncRect(SyncType syncType, size_t offset, size_t width, size_t height, size_t rowPitch,
+                  size_t depth = 1, size_t slicePitch = 0);
+
+    /**
+     * @brief Gets the host memory of the buffer.
+     * @return A pointer to the first byte of the host memory.
+     */
+    void* getHostPtr() const override;
+
+    /**
+     * @brief Gets the size of the buffer in bytes.
+     * @return The size of the buffer in bytes.
+     */
+    std::size_t getSizeInBytes() const override;
+
+    /**
+     * @brief Gets the byte ranges a synchronization has to transfer.
+     *
+     * With dirty tracking enabled, a host to device synchronization returns the runs of
+     * modified pages. Otherwise the whole buffer is returned.
+     *
+     * @param syncType The type of synchronization.
+     * @return The byte ranges to transfer.
+     */
+    std::vector<SyncRange> getSyncRanges(SyncType syncType) const override;
+
+    /**
+     * @brief Records that the ranges returned by getSyncRanges() have been transferred.
+     *
+     * With dirty tracking enabled, all pages are marked as clean.
+     *
+     * @param syncType The type of synchronization.
+     */
+    void markSynced(SyncType syncType) override;
+
+    /**
+     * @brief Gets the memory flags of the buffer.
+     * @return The memory flags.
+     */
+    MemoryFlags getFlags() const;
+
+    /**
+     * @brief Checks if the buffer currently has host memory.
+     * @return True unless a device-only buffer has not been accessed from the host yet.
+     */
+    bool hasHostMemory() const;
+
+    /**
+     * @brief Enables or disables dirty tracking.
+     *
+     * Enabling marks the whole buffer as modified, so the next host to device synchronization
+     * transfers everything. Writes through get() are not tracked; use markDirty() for those.
+     *
+     * @param enable Flag indicating whether to track modified pages.
+     */
+    void setDirtyTracking(bool enable);
+
+    /**
+     * @brief Checks whether dirty tracking is enabled.
+     * @return True if dirty tracking is enabled.
+     */
+    bool isDirtyTracking() const;
+
+    /**
+     * @brief Marks a range of elements as modified.
+     * @param offset The index of the first element.
+     * @param count The number of elements.
+     */
+    void markDirty(size_t offset, size_t count);
+
+    /**
+     * @brief Synchronizes the buffer asynchronously on the device I/O engine.
+     *
+     * The call returns immediately. The buffer must stay alive, must not be moved, and its host
+     * memory must not be accessed until the returned event has completed.
+     *
+     * @param syncType The type of synchronization.
+     * @return An event that completes when the transfer has finished.
+     */
+    SyncEvent syncAsync(SyncType syncType);
+
+    /**
+     * @brief Synchronizes a range of the buffer asynchronously on the device I/O engine.
+     * @param syncType The type of synchronization.
+     * @param offset The index of the first element to synchronize.
+     * @param count The number of elements to synchronize.
+     * @return An event that completes when the transfer has finished.
+     */
+    SyncEvent syncAsync(SyncType syncType, size_t offset, size_t count);
 
     std::string getName();
 
@@ -121,14 +367,66 @@ class Buffer {
     Buffer(Buffer&& other) noexcept;
     Buffer& operator=(Buffer&& other) noexcept;
 
+    /// Granularity of dirty tracking in bytes
+    static constexpr size_t DIRTY_PAGE_SIZE = 4096;
+
    private:
-    uint64_t startAddress;           ///< The starting address of the buffer
-    T* localBuffer;                  ///< Pointer to the local buffer
-    size_t size;                     ///< The size of the buffer
-    MemoryRangeType type;            ///< The type of memory range
-    Device device;                   ///< The device associated with the buffer
-    std::size_t index;               // Member variable to store the index of the buffer
-    static std::size_t bufferIndex;  // Static variable to track the buffer index
+    /**
+     * @brief Allocates and default-initializes the host buffer from the device host allocator.
+     */
+    void allocateHost();
+
+    /**
+     * @brief Registers the buffer with the emulator under its physical address.
+     *
+     * Device-only buffers are created zeroed, others with the contents of the host buffer, so
+     * later sub-range and dirty-page syncs find a buffer of the full size. Does nothing on
+     * other platforms.
+     */
+    void registerEmulation();
+
+    /**
+     * @brief Destroys and releases the host buffer.
+     */
+    void releaseHost();
+
+    /**
+     * @brief Releases the device memory to the allocator or detaches from the arena.
+     */
+    void releaseDevice();
+
+    /**
+     * @brief Allocates the host buffer of a device-only buffer on first use.
+     */
+    void ensureHost() const;
+
+    /**
+     * @brief Transfers a byte range between the host buffer and the device.
+     * @param syncType The type of synchronization.
+     * @param byteOffset The byte offset inside the buffer.
+     * @param byteCount The number of bytes to transfer.
+     */
+    void transfer(SyncType syncType, size_t byteOffset, size_t byteCount);
+
+    /**
+     * @brief Clears the dirty pages fully covered by a byte range.
+     * @param byteOffset The byte offset inside the buffer.
+     * @param byteCount The number of bytes.
+     */
+    void clearDirty(size_t byteOffset, size_t byteCount);
+
+    uint64_t startAddress;                  ///< The starting address of the buffer
+    mutable T* localBuffer = nullptr;       ///< Pointer to the local buffer
+    size_t size;                            ///< The size of the buffer
+    MemoryRangeType type;                   ///< The type of memory range
+    Device device;                          ///< The device associated with the buffer
+    std::size_t index;                      // Member variable to store the index of the buffer
+    static std::size_t bufferIndex;         // Static variable to track the buffer index
+    bool dirtyTracking = false;             ///< Flag indicating whether modified pages are tracked
+    std::vector<bool> dirtyPages;           ///< Modified pages of the host buffer
+    bool ownsHost = true;                   ///< Flag indicating whether the host buffer is owned
+    MemoryFlags flags = MemoryFlags::NONE;  ///< Memory flags of the buffer
+    Arena* arena = nullptr;                 ///< Arena holding the device memory, if any
 };
 
 template <typename T>
@@ -136,50 +434,169 @@ size_t Buffer<T>::bufferIndex = 0;
 
 template <typename T>
 Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type)
-    : device(device), size(size), type(type), index(bufferIndex++) {
-    startAddress = device.getAllocator()->allocate(size * sizeof(T), type);
+    : Buffer(device, size, type, MemoryFlags::NONE) {}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port)
+    : Buffer(device, size, type, port, MemoryFlags::NONE) {}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type, MemoryFlags flags)
+    : Buffer(device, size, type, device.getAllocator()->getDefaultPolicy(), flags) {}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port,
+                  MemoryFlags flags)
+    : Buffer(device, size, type, port, device.getAllocator()->getDefaultPolicy(), flags) {}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type,
+                  const AllocationPolicy& policy, MemoryFlags flags)
+    : device(device), size(size), type(type), index(bufferIndex++), flags(flags) {
+    startAddress = device.getAllocator()->allocate(size * sizeof(T), type, policy);
     if (startAddress == 0) {
         throw std::bad_alloc();
     }
 
-    localBuffer = new T[size];
-    Platform platform = device.getPlatform();
-    if (platform == Platform::EMULATION) {
-        // send initial buffer so it is populated in the emulation environment
-        std::shared_ptr<ZmqServer> server = device.getZmqServer();
-        std::vector<uint8_t> sendData;
-        std::size_t dataSize = size * sizeof(T);
-        sendData.resize(dataSize);
-        std::memcpy(sendData.data(), localBuffer, dataSize);
-        server->sendBuffer(std::to_string(getPhysAddr()), sendData);
+    if (flags != MemoryFlags::DEVICE_ONLY) {
+        allocateHost();
     }
+    registerEmulation();
 }
 
 template <typename T>
-Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port)
+Buffer<T>::Buffer(Device device, size_t size, MemoryRangeType type, uint8_t port,
+                  const AllocationPolicy& policy, MemoryFlags flags)
+    : device(device), size(size), type(type), index(bufferIndex++), flags(flags) {
+    startAddress = device.getAllocator()->allocate(size * sizeof(T), type, port, policy);
+    if (startAddress == 0) {
+        throw std::bad_alloc();
+    }
+
+    if (flags != MemoryFlags::DEVICE_ONLY) {
+        allocateHost();
+    }
+    registerEmulation();
+}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, size_t size, const Kernel& kernel, const std::string& argument,
+                  MemoryFlags flags)
+    : Buffer(device, size, MemoryRangeType::HBM, kernel.getMemoryPort(argument), flags) {}
+
+template <typename T>
+Buffer<T>::Buffer(Arena& arena, size_t size, MemoryFlags flags)
+    : device(arena.getDevice()),
+      size(size),
+      type(arena.getType()),
+      index(bufferIndex++),
+      flags(flags),
+      arena(&arena) {
+    startAddress = arena.allocate(size * sizeof(T));
+    arena.attach();
+
+    if (flags != MemoryFlags::DEVICE_ONLY) {
+        allocateHost();
+    }
+    registerEmulation();
+}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, T* hostPtr, size_t size, MemoryRangeType type)
     : device(device), size(size), type(type), index(bufferIndex++) {
-    this->device = device;
+    if (hostPtr == nullptr) {
+        throw std::invalid_argument("Host pointer must not be null");
+    }
+    startAddress = device.getAllocator()->allocate(size * sizeof(T), type);
+    if (startAddress == 0) {
+        throw std::bad_alloc();
+    }
 
+    localBuffer = hostPtr;
+    ownsHost = false;
+    registerEmulation();
+}
+
+template <typename T>
+Buffer<T>::Buffer(Device device, T* hostPtr, size_t size, MemoryRangeType type, uint8_t port)
+    : device(device), size(size), type(type), index(bufferIndex++) {
+    if (hostPtr == nullptr) {
+        throw std::invalid_argument("Host pointer must not be null");
+    }
     startAddress = device.getAllocator()->allocate(size * sizeof(T), type, port);
     if (startAddress == 0) {
         throw std::bad_alloc();
     }
 
-    localBuffer = new T[size];
+    localBuffer = hostPtr;
+    ownsHost = false;
+    registerEmulation();
 }
 
 template <typename T>
 Buffer<T>::~Buffer() {
+    releaseDevice();
+    releaseHost();
+}
+
+template <typename T>
+void Buffer<T>::releaseDevice() {
     if (startAddress != 0) {
-        device.getAllocator()->deallocate(startAddress);
+        if (device.getPlatform() == Platform::EMULATION) {
+            // the address may be reused, so the emulator must not keep the old contents
+            device.getZmqServer()->freeBuffer(std::to_string(getPhysAddr()));
+        }
+        if (arena != nullptr) {
+            arena->detach();
+        } else {
+            device.getAllocator()->deallocate(startAddress);
+        }
+    }
+    startAddress = 0;
+    arena = nullptr;
+}
+
+template <typename T>
+void Buffer<T>::allocateHost() {
+    localBuffer = static_cast<T*>(device.getHostAllocator()->allocate(size * sizeof(T)));
+    std::uninitialized_default_construct_n(localBuffer, size);
+}
+
+template <typename T>
+void Buffer<T>::registerEmulation() {
+    if (device.getPlatform() != Platform::EMULATION) {
+        return;
     }
-    if (localBuffer != nullptr) {
-        delete[] localBuffer;
+    std::string name = std::to_string(getPhysAddr());
+    if (flags == MemoryFlags::DEVICE_ONLY) {
+        device.getZmqServer()->allocateBuffer(name, size * sizeof(T));
+        return;
     }
+    std::vector<uint8_t> sendData(reinterpret_cast<uint8_t*>(localBuffer),
+                                  reinterpret_cast<uint8_t*>(localBuffer) + size * sizeof(T));
+    device.getZmqServer()->sendBuffer(name, sendData);
+}
+
+template <typename T>
+void Buffer<T>::ensureHost() const {
+    if (localBuffer == nullptr && size > 0) {
+        localBuffer = static_cast<T*>(device.getHostAllocator()->allocate(size * sizeof(T)));
+        std::uninitialized_value_construct_n(localBuffer, size);
+    }
+}
+
+template <typename T>
+void Buffer<T>::releaseHost() {
+    if (localBuffer != nullptr && ownsHost) {
+        std::destroy_n(localBuffer, size);
+        device.getHostAllocator()->deallocate(localBuffer);
+    }
+    localBuffer = nullptr;
 }
 
 template <typename T>
 T* Buffer<T>::get() const {
+    ensureHost();
     return localBuffer;
 }
 
@@ -188,6 +605,10 @@ T& Buffer<T>::operator[](size_t index) {
     if (index >= size) {
         throw std::out_of_range("Index out of range");
     }
+    ensureHost();
+    if (dirtyTracking) {
+        dirtyPages[index * sizeof(T) / DIRTY_PAGE_SIZE] = true;
+    }
     return localBuffer[index];
 }
 
@@ -196,9 +617,70 @@ const T& Buffer<T>::operator[](size_t index) const {
     if (index >= size) {
         throw std::out_of_range("Index out of range");
     }
+    ensureHost();
     return localBuffer[index];
 }
 
+template <typename T>
+T* Buffer<T>::getSpan(size_t offset, size_t count) {
+    if (offset > size || count > size - offset) {
+        throw std::out_of_range("Range out of bounds");
+    }
+    ensureHost();
+    markDirty(offset, count);
+    return localBuffer + offset;
+}
+
+template <typename T>
+MemoryFlags Buffer<T>::getFlags() const {
+    return flags;
+}
+
+template <typename T>
+bool Buffer<T>::hasHostMemory() const {
+    return localBuffer != nullptr;
+}
+
+template <typename T>
+void Buffer<T>::setDirtyTracking(bool enable) {
+    dirtyTracking = enable;
+    if (enable) {
+        dirtyPages.assign((size * sizeof(T) + DIRTY_PAGE_SIZE - 1) / DIRTY_PAGE_SIZE, true);
+    } else {
+        dirtyPages.clear();
+    }
+}
+
+template <typename T>
+bool Buffer<T>::isDirtyTracking() const {
+    return dirtyTracking;
+}
+
+template <typename T>
+void Buffer<T>::markDirty(size_t offset, size_t count) {
+    if (!dirtyTracking || count == 0 || offset >= size) {
+        return;
+    }
+    count = std::min(count, size - offset);
+    size_t firstPage = offset * sizeof(T) / DIRTY_PAGE_SIZE;
+    size_t lastPage = ((offset + count) * sizeof(T) - 1) / DIRTY_PAGE_SIZE;
+    std::fill(dirtyPages.begin() + firstPage, dirtyPages.begin() + lastPage + 1, true);
+}
+
+template <typename T>
+void Buffer<T>::clearDirty(size_t byteOffset, size_t byteCount) {
+    if (!dirtyTracking) {
+        return;
+    }
+    size_t byteEnd = byteOffset + byteCount;
+    size_t firstPage = (byteOffset + DIRTY_PAGE_SIZE - 1) / DIRTY_PAGE_SIZE;
+    // the last page may be partial, it is covered when the range reaches the end of the buffer
+    size_t endPage = (byteEnd == size * sizeof(T)) ? dirtyPages.size() : byteEnd / DIRTY_PAGE_SIZE;
+    for (size_t page = firstPage; page < endPage; page++) {
+        dirtyPages[page] = false;
+    }
+}
+
 template <typename T>
 uint64_t Buffer<T>::getPhysAddr() const {
     return startAddress;
@@ -219,43 +701,207 @@ std::string Buffer<T>::getName() {
     return "buffer_" + std::to_string(index);
 }
 
+template <typename T>
+void* Buffer<T>::getHostPtr() const {
+    ensureHost();
+    return localBuffer;
+}
+
+template <typename T>
+std::size_t Buffer<T>::getSizeInBytes() const {
+    return size * sizeof(T);
+}
+
+template <typename T>
+std::vector<SyncRange> Buffer<T>::getSyncRanges(SyncType syncType) const {
+    size_t totalSize = size * sizeof(T);
+    if (!dirtyTracking || syncType != SyncType::HOST_TO_DEVICE) {
+        return {{0, totalSize}};
+    }
+    std::vector<SyncRange> ranges;
+    size_t page = 0;
+    while (page < dirtyPages.size()) {
+        if (!dirtyPages[page]) {
+            page++;
+            continue;
+        }
+        size_t firstPage = page;
+        while (page < dirtyPages.size() && dirtyPages[page]) {
+            page++;
+        }
+        size_t byteOffset = firstPage * DIRTY_PAGE_SIZE;
+        size_t byteEnd = std::min(page * DIRTY_PAGE_SIZE, totalSize);
+        ranges.push_back({byteOffset, byteEnd - byteOffset});
+    }
+    return ranges;
+}
+
+template <typename T>
+void Buffer<T>::markSynced(SyncType syncType) {
+    if (dirtyTracking) {
+        std::fill(dirtyPages.begin(), dirtyPages.end(), false);
+    }
+}
+
 template <typename T>
 void Buffer<T>::sync(SyncType syncType) {
+    for (const SyncRange& range : getSyncRanges(syncType)) {
+        transfer(syncType, range.byteOffset, range.byteCount);
+    }
+    markSynced(syncType);
+}
+
+template <typename T>
+void Buffer<T>::sync(SyncType syncType, size_t offset, size_t count) {
+    if (offset > size || count > size - offset) {
+        throw std::out_of_range("Sync range out of bounds");
+    }
+    transfer(syncType, offset * sizeof(T), count * sizeof(T));
+    clearDirty(offset * sizeof(T), count * sizeof(T));
+}
+
+template <typename T>
+void Buffer<T>::syncRect(SyncType syncType, size_t offset, size_t width, size_t height,
+                         size_t rowPitch, size_t depth, size_t slicePitch) {
+    syncRect(syncType,
+             {offset, offset, width, height, depth, rowPitch, slicePitch, rowPitch, slicePitch});
+}
+
+template <typename T>
+void Buffer<T>::syncRect(SyncType syncType, const SyncRect& rect) {
+    if (rect.width == 0 || rect.height == 0 || rect.depth == 0) {
+        return;
+    }
+    size_t hostRowPitch = rect.hostRowPitch ? rect.hostRowPitch : rect.width;
+    size_t hostSlicePitch = rect.hostSlicePitch ? rect.hostSlicePitch : hostRowPitch * rect.height;
+    size_t deviceRowPitch = rect.deviceRowPitch ? rect.deviceRowPitch : rect.width;
+    size_t deviceSlicePitch =
+        rect.deviceSlicePitch ? rect.deviceSlicePitch : deviceRowPitch * rect.height;
+    size_t hostSliceExtent = (rect.height - 1) * hostRowPitch + rect.width;
+    size_t deviceSliceExtent = (rect.height - 1) * deviceRowPitch + rect.width;
+    if (hostRowPitch < rect.width || deviceRowPitch < rect.width ||
+        (rect.depth > 1 &&
+         (hostSlicePitch < hostSliceExtent || deviceSlicePitch < deviceSliceExtent))) {
+        throw std::invalid_argument("Pitch smaller than the region");
+    }
+    size_t hostExtent = (rect.depth - 1) * hostSlicePitch + hostSliceExtent;
+    size_t deviceExtent = (rect.depth - 1) * deviceSlicePitch + deviceSliceExtent;
+    if (rect.hostOffset > size || hostExtent > size - rect.hostOffset ||
+        rect.deviceOffset > size || deviceExtent > size - rect.deviceOffset) {
+        throw std::out_of_range("Sync region out of bounds");
+    }
+
+    // one (host index, device index) pair per row
+    std::vector<std::pair<size_t, size_t>> rows;
+    rows.reserve(rect.height * rect.depth);
+    for (size_t z = 0; z < rect.depth; z++) {
+        for (size_t y = 0; y < rect.height; y++) {
+            rows.push_back({rect.hostOffset + z * hostSlicePitch + y * hostRowPitch,
+                            rect.deviceOffset + z * deviceSlicePitch + y * deviceRowPitch});
+        }
+    }
+    size_t rowBytes = rect.width * sizeof(T);
+    ensureHost();
+    char* hostBase = reinterpret_cast<char*>(localBuffer);
+
     Platform platform = device.getPlatform();
     if (platform == Platform::HARDWARE) {
-        size_t maxChunkSize = 1 << 24;  // 22
-        size_t totalSize = size * sizeof(T);
-        size_t chunkSize = maxChunkSize * sizeof(T);
-        size_t offset = 0;
-
-        while (totalSize > 0) {
-            size_t currentChunkSize = std::min(chunkSize, totalSize);
+        std::vector<QdmaSegment> segments;
+        segments.reserve(rows.size());
+        for (const auto& row : rows) {
+            segments.push_back({hostBase + row.first * sizeof(T),
+                                startAddress + row.second * sizeof(T), rowBytes});
+        }
+        if (syncType == SyncType::HOST_TO_DEVICE) {
+            device.qdmaIntf.write_batch(segments);
+        } else {
+            device.qdmaIntf.read_batch(segments);
+        }
+    } else if (platform == Platform::EMULATION) {
+        std::shared_ptr<ZmqServer> server = device.getZmqServer();
+        std::string name = std::to_string(getPhysAddr());
+        std::vector<ZmqBufferRange> ranges;
+        ranges.reserve(rows.size());
+        for (const auto& row : rows) {
+            ranges.push_back({name, row.second * sizeof(T), rowBytes});
+        }
+        if (syncType == SyncType::HOST_TO_DEVICE) {
+            std::vector<uint8_t> sendData;
+            sendData.reserve(rows.size() * rowBytes);
+            for (const auto& row : rows) {
+                char* rowPtr = hostBase + row.first * sizeof(T);
+                sendData.insert(sendData.end(), rowPtr, rowPtr + rowBytes);
+            }
+            server->sendBufferBatch(ranges, sendData);
+        } else {
+            std::vector<uint8_t> recvData = server->fetchBufferBatch(ranges);
+            for (size_t i = 0; i < rows.size() && (i + 1) * rowBytes <= recvData.size(); i++) {
+                std::memcpy(hostBase + rows[i].first * sizeof(T), recvData.data() + i * rowBytes,
+                            rowBytes);
+            }
+        }
+    } else if (platform == Platform::SIMULATION) {
+        std::shared_ptr<ZmqServer> server = device.getZmqServer();
+        for (const auto& row : rows) {
+            char* rowPtr = hostBase + row.first * sizeof(T);
+            uint64_t rowAddr = startAddress + row.second * sizeof(T);
             if (syncType == SyncType::HOST_TO_DEVICE) {
-                this->device.qdmaIntf.write_buff(reinterpret_cast<char*>(localBuffer) + offset,
-                                                 startAddress + offset, currentChunkSize);
-            } else if (syncType == SyncType::DEVICE_TO_HOST) {
-                this->device.qdmaIntf.read_buff(reinterpret_cast<char*>(localBuffer) + offset,
-                                                startAddress + offset, currentChunkSize);
+                server->sendBufferSim(rowAddr, std::vector<uint8_t>(rowPtr, rowPtr + rowBytes));
             } else {
-                throw std::invalid_argument("Invalid sync type");
+                std::vector<uint8_t> recvData;
+                server->fetchBufferSim(rowAddr, rowBytes, recvData);
+                std::memcpy(rowPtr, recvData.data(), std::min(recvData.size(), rowBytes));
             }
-            offset += currentChunkSize;
-            totalSize -= currentChunkSize;
+        }
+    }
+
+    if (!dirtyTracking) {
+        return;
+    }
+    bool sameLayout = rect.hostOffset == rect.deviceOffset && hostRowPitch == deviceRowPitch &&
+                      (rect.depth == 1 || hostSlicePitch == deviceSlicePitch);
+    for (const auto& row : rows) {
+        if (sameLayout) {
+            clearDirty(row.first * sizeof(T), rowBytes);
+        } else if (syncType == SyncType::HOST_TO_DEVICE) {
+            // the device rows no longer match the host elements at the same positions
+            markDirty(row.second, rect.width);
+        } else {
+            markDirty(row.first, rect.width);
+        }
+    }
+}
+
+template <typename T>
+void Buffer<T>::transfer(SyncType syncType, size_t byteOffset, size_t byteCount) {
+    ensureHost();
+    char* hostPtr = reinterpret_cast<char*>(localBuffer) + byteOffset;
+    bool wholeBuffer = (byteOffset == 0 && byteCount == size * sizeof(T));
+    Platform platform = device.getPlatform();
+    if (platform == Platform::HARDWARE) {
+        // chunking and pipelining are done by the transfer engine, independent of T
+        if (syncType == SyncType::HOST_TO_DEVICE) {
+            this->device.qdmaIntf.write_buff(hostPtr, startAddress + byteOffset, byteCount);
+        } else if (syncType == SyncType::DEVICE_TO_HOST) {
+            this->device.qdmaIntf.read_buff(hostPtr, startAddress + byteOffset, byteCount);
+        } else {
+            throw std::invalid_argument("Invalid sync type");
         }
     } else if (platform == Platform::EMULATION) {
         std::shared_ptr<ZmqServer> server = device.getZmqServer();
         if (syncType == SyncType::HOST_TO_DEVICE) {
-            std::vector<uint8_t> sendData;
-            std::size_t dataSize = size * sizeof(T);
-            sendData.resize(dataSize);
-            std::memcpy(sendData.data(), localBuffer, dataSize);
-            server->sendBuffer(std::to_string(getPhysAddr()), sendData);
+            std::vector<uint8_t> sendData(hostPtr, hostPtr + byteCount);
+            if (wholeBuffer) {
+                server->sendBuffer(std::to_string(getPhysAddr()), sendData);
+            } else {
+                server->sendBufferRange(std::to_string(getPhysAddr()), byteOffset, sendData);
+            }
         } else if (syncType == SyncType::DEVICE_TO_HOST) {
-            std::vector<uint8_t> recvData = server->fetchBuffer(std::to_string(getPhysAddr()));
-            size = recvData.size() / sizeof(T);
-            localBuffer = reinterpret_cast<T*>(realloc(localBuffer, recvData.size()));
-            std::memcpy(localBuffer, recvData.data(), recvData.size());
-
+            std::string name = std::to_string(getPhysAddr());
+            std::vector<uint8_t> recvData =
+                wholeBuffer ? server->fetchBuffer(name)
+                            : server->fetchBufferRange(name, byteOffset, byteCount);
+            std::memcpy(hostPtr, recvData.data(), std::min(recvData.size(), byteCount));
         } else {
             throw std::invalid_argument("Invalid sync type");
         }
@@ -263,23 +909,37 @@ void Buffer<T>::sync(SyncType syncType) {
     } else if (platform == Platform::SIMULATION) {
         std::shared_ptr<ZmqServer> server = device.getZmqServer();
         if (syncType == SyncType::HOST_TO_DEVICE) {
-            std::vector<uint8_t> sendData;
-            std::size_t dataSize = size * sizeof(T);
-            sendData.resize(dataSize);
-            std::memcpy(sendData.data(), localBuffer, dataSize);
-            server->sendBufferSim(getPhysAddr(), sendData);
+            std::vector<uint8_t> sendData(hostPtr, hostPtr + byteCount);
+            server->sendBufferSim(getPhysAddr() + byteOffset, sendData);
         } else if (syncType == SyncType::DEVICE_TO_HOST) {
             std::vector<uint8_t> recvData;
-            server->fetchBufferSim(getPhysAddr(), size * sizeof(T), recvData);
-
-            size = recvData.size() * sizeof(T);
-            localBuffer = reinterpret_cast<T*>(realloc(localBuffer, recvData.size()));
-            std::memcpy(localBuffer, recvData.data(), recvData.size());
+            server->fetchBufferSim(getPhysAddr() + byteOffset, byteCount, recvData);
+            std::memcpy(hostPtr, recvData.data(), std::min(recvData.size(), byteCount));
         } else {
             throw std::invalid_argument("Invalid sync type");
         }
     }
 }
+
+template <typename T>
+SyncEvent Buffer<T>::syncAsync(SyncType syncType) {
+    std::shared_ptr<IoEngine> engine = device.getIoEngine();
+    if (!engine) {
+        throw std::runtime_error("Device has no I/O engine");
+    }
+    return SyncEvent::submit(engine, [this, syncType]() { sync(syncType); });
+}
+
+template <typename T>
+SyncEvent Buffer<T>::syncAsync(SyncType syncType, size_t offset, size_t count) {
+    std::shared_ptr<IoEngine> engine = device.getIoEngine();
+    if (!engine) {
+        throw std::runtime_error("Device has no I/O engine");
+    }
+    return SyncEvent::submit(engine,
+                             [this, syncType, offset, count]() { sync(syncType, offset, count); });
+}
+
 template <typename T>
 Buffer<T>::Buffer(Buffer&& other) noexcept
     : device(other.device),
@@ -287,22 +947,24 @@ Buffer<T>::Buffer(Buffer&& other) noexcept
       type(other.type),
       index(other.index),
       startAddress(other.startAddress),
-      localBuffer(other.localBuffer) {
+      localBuffer(other.localBuffer),
+      dirtyTracking(other.dirtyTracking),
+      dirtyPages(std::move(other.dirtyPages)),
+      ownsHost(other.ownsHost),
+      flags(other.flags),
+      arena(other.arena) {
     other.startAddress = 0;
+    other.arena = nullptr;
     other.localBuffer = nullptr;
     other.size = 0;
+    other.dirtyTracking = false;
 }
 
 template <typename T>
 Buffer<T>& Buffer<T>::operator=(Buffer&& other) noexcept {
     if (this != &other) {
-        if (localBuffer) {
-            delete[] localBuffer;
-        }
-
-        if (startAddress != 0) {
-            device.getAllocator()->deallocate(startAddress);
-        }
+        releaseHost();
+        releaseDevice();
 
         device = other.device;
         size = other.size;
@@ -310,10 +972,17 @@ Buffer<T>& Buffer<T>::operator=(Buffer&& other) noexcept {
         index = other.index;
         startAddress = other.startAddress;
         localBuffer = other.localBuffer;
+        dirtyTracking = other.dirtyTracking;
+        dirtyPages = std::move(other.dirtyPages);
+        ownsHost = other.ownsHost;
+        flags = other.flags;
+        arena = other.arena;
 
         other.startAddress = 0;
+        other.arena = nullptr;
         other.localBuffer = nullptr;
         other.size = 0;
+        other.dirtyTracking = false;
     }
     return *this;
 }
@@ -0,0 +1,127 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef BUFFER_BASE_HPP
+#define BUFFER_BASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vrt {
+
+/**
+ * @brief Enum class representing the type of synchronization.
+ */
+enum class SyncType {
+    HOST_TO_DEVICE,  ///< Synchronize from host to device
+    DEVICE_TO_HOST,  ///< Synchronize from device to host
+};
+
+/**
+ * @brief Enum class representing the memory placement of a buffer.
+ */
+enum class MemoryFlags {
+    NONE,         ///< Device memory with a host copy
+    DEVICE_ONLY,  ///< Device memory only, the host copy is created on first access
+};
+
+/**
+ * @brief Struct representing a byte range of a buffer to synchronize.
+ */
+struct SyncRange {
+    uint64_t byteOffset;        ///< Byte offset inside the buffer
+    uint64_t byteCount;         ///< Number of bytes
+    uint64_t regionOffset = 0;  ///< Byte offset of the device object holding the range
+};
+
+/**
+ * @brief Struct describing a strided 2D/3D region of a buffer, in elements.
+ *
+ * Host and device may use different pitches, so a region can be gathered from one layout and
+ * scattered into another. A pitch of 0 selects the tightly packed value.
+ */
+struct SyncRect {
+    std::size_t hostOffset;            ///< Index of the first host element
+    std::size_t deviceOffset;          ///< Index of the first device element
+    std::size_t width;                 ///< Elements per row
+    std::size_t height = 1;            ///< Rows per slice
+    std::size_t depth = 1;             ///< Number of slices
+    std::size_t hostRowPitch = 0;      ///< Elements between host rows, 0 for width
+    std::size_t hostSlicePitch = 0;    ///< Elements between host slices, 0 for height rows
+    std::size_t deviceRowPitch = 0;    ///< Elements between device rows, 0 for width
+    std::size_t deviceSlicePitch = 0;  ///< Elements between device slices, 0 for height rows
+};
+
+/**
+ * @brief Type-independent interface of a memory mapped buffer.
+ *
+ * The interface exposes what the runtime needs to move a buffer without knowing its element
+ * type, so buffers of different types can be synchronized in one batch.
+ */
+class BufferBase {
+   public:
+    /**
+     * @brief Virtual destructor for BufferBase.
+     */
+    virtual ~BufferBase() = default;
+
+    /**
+     * @brief Gets the physical address of the buffer.
+     * @return The physical address of the buffer.
+     */
+    virtual uint64_t getPhysAddr() const = 0;
+
+    /**
+     * @brief Gets the host memory of the buffer.
+     * @return A pointer to the first byte of the host memory.
+     */
+    virtual void* getHostPtr() const = 0;
+
+    /**
+     * @brief Gets the size of the buffer in bytes.
+     * @return The size of the buffer in bytes.
+     */
+    virtual std::size_t getSizeInBytes() const = 0;
+
+    /**
+     * @brief Gets the byte ranges a synchronization has to transfer.
+     * @param syncType The type of synchronization.
+     * @return The byte ranges, the whole buffer unless dirty tracking narrows it down.
+     */
+    virtual std::vector<SyncRange> getSyncRanges(SyncType syncType) const = 0;
+
+    /**
+     * @brief Records that the ranges returned by getSyncRanges() have been transferred.
+     * @param syncType The type of synchronization.
+     */
+    virtual void markSynced(SyncType syncType) = 0;
+
+    /**
+     * @brief Synchronizes the buffer.
+     * @param syncType The type of synchronization.
+     */
+    virtual void sync(SyncType syncType) = 0;
+};
+
+}  // namespace vrt
+
+#endif  // BUFFER_BASE_HPP
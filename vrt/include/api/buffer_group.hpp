@@ -0,0 +1,213 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef BUFFER_GROUP_HPP
+#define BUFFER_GROUP_HPP
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "allocator/allocator.hpp"
+#include "api/buffer_base.hpp"
+#include "api/device.hpp"
+
+namespace vrt {
+
+/**
+ * @brief Class representing a group of buffers placed back-to-back in device memory.
+ *
+ * Members are declared with add() and placed in one device region when allocate() is called.
+ * Their host copies live in one contiguous slab, so the whole group is synchronized as a single
+ * DMA transfer instead of one transfer per member. This suits many small buffers, such as kernel
+ * parameters, whose individual transfers would be dominated by latency.
+ */
+class BufferGroup : public BufferBase {
+   public:
+    /// Alignment of the members inside the group, one 512 bit AXI beat
+    static constexpr std::size_t MEMBER_ALIGNMENT = 64;
+
+    /**
+     * @brief Constructor for BufferGroup.
+     * @param device VRT Device of the group.
+     * @param type The type of memory range.
+     */
+    BufferGroup(Device device, MemoryRangeType type);
+
+    /**
+     * @brief Constructor for BufferGroup.
+     * @param device VRT Device of the group.
+     * @param type The type of memory range.
+     * @param port The HBM port number. This would not have any effect if the type is DDR.
+     */
+    BufferGroup(Device device, MemoryRangeType type, uint8_t port);
+
+    /**
+     * @brief Destructor for BufferGroup.
+     */
+    ~BufferGroup() override;
+
+    BufferGroup(const BufferGroup&) = delete;
+    BufferGroup& operator=(const BufferGroup&) = delete;
+
+    /**
+     * @brief Declares a member of the group.
+     * @tparam T The type of the elements of the member.
+     * @param count The number of elements.
+     * @return The index of the member.
+     * @throws std::logic_error If the group is already allocated.
+     */
+    template <typename T>
+    std::size_t add(std::size_t count);
+
+    /**
+     * @brief Allocates the device region and the host slab of all declared members.
+     * @throws std::logic_error If the group is already allocated or has no members.
+     */
+    void allocate();
+
+    /**
+     * @brief Checks if the group is allocated.
+     * @return True if allocate() has been called.
+     */
+    bool isAllocated() const;
+
+    /**
+     * @brief Gets the host memory of a member.
+     * @tparam T The type of the elements of the member.
+     * @param member The index of the member.
+     * @return A pointer to the first element of the member.
+     */
+    template <typename T>
+    T* get(std::size_t member) const;
+
+    /**
+     * @brief Gets the physical address of a member.
+     * @param member The index of the member.
+     * @return The physical address of the member.
+     */
+    uint64_t getPhysAddr(std::size_t member) const;
+
+    /**
+     * @brief Gets the size of a member in bytes.
+     * @param member The index of the member.
+     * @return The size of the member in bytes.
+     */
+    std::size_t getMemberSize(std::size_t member) const;
+
+    /**
+     * @brief Gets the number of members.
+     * @return The number of members.
+     */
+    std::size_t getMemberCount() const;
+
+    /**
+     * @brief Gets the physical address of the group.
+     * @return The physical address of the first member.
+     */
+    uint64_t getPhysAddr() const override;
+
+    /**
+     * @brief Gets the host slab of the group.
+     * @return A pointer to the first byte of the slab.
+     */
+    void* getHostPtr() const override;
+
+    /**
+     * @brief Gets the size of the group in bytes, including the padding between members.
+     * @return The size of the group in bytes.
+     */
+    std::size_t getSizeInBytes() const override;
+
+    /**
+     * @brief Gets the byte ranges of the members.
+     *
+     * Every range covers a member and the padding after it, so the ranges are adjacent and
+     * batched transfers merge them into one.
+     *
+     * @param syncType The type of synchronization.
+     * @return One range per member.
+     */
+    std::vector<SyncRange> getSyncRanges(SyncType syncType) const override;
+
+    /**
+     * @brief Records a completed synchronization. Groups keep no dirty state.
+     * @param syncType The type of synchronization.
+     */
+    void markSynced(SyncType syncType) override;
+
+    /**
+     * @brief Synchronizes all members of the group.
+     * @param syncType The type of synchronization.
+     */
+    void sync(SyncType syncType) override;
+
+   private:
+    /**
+     * @brief Struct describing a member of the group.
+     */
+    struct Member {
+        std::size_t offset;  ///< Byte offset inside the group
+        std::size_t size;    ///< Size in bytes
+    };
+
+    /**
+     * @brief Declares a member by size and alignment.
+     * @param size The size in bytes.
+     * @param alignment The alignment of the element type.
+     * @return The index of the member.
+     */
+    std::size_t addMember(std::size_t size, std::size_t alignment);
+
+    /**
+     * @brief Gets a member, checking the index and the allocation.
+     * @param member The index of the member.
+     * @return The member.
+     */
+    const Member& getMember(std::size_t member) const;
+
+    Device device;                ///< VRT Device of the group
+    MemoryRangeType type;         ///< Type of memory range
+    int port;                     ///< HBM port, -1 if none was requested
+    std::vector<Member> members;  ///< Members in declaration order
+    std::size_t totalSize = 0;    ///< Size of the group in bytes
+    uint64_t startAddress = 0;    ///< Physical address of the group
+    char* hostSlab = nullptr;     ///< Host memory of the group
+};
+
+template <typename T>
+std::size_t BufferGroup::add(std::size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Buffer group members must be trivially copyable");
+    return addMember(count * sizeof(T), alignof(T));
+}
+
+template <typename T>
+T* BufferGroup::get(std::size_t member) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Buffer group members must be trivially copyable");
+    return reinterpret_cast<T*>(hostSlab + getMember(member).offset);
+}
+
+}  // namespace vrt
+
+#endif  // BUFFER_GROUP_HPP
@@ -32,11 +32,15 @@
 #include <sys/file.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <thread>
 
 #include "allocator/allocator.hpp"
+#include "allocator/host_allocator.hpp"
+#include "api/buffer_base.hpp"
 #include "api/kernel.hpp"
 #include "api/vrt_version.hpp"
 #include "api/vrtbin.hpp"
@@ -46,6 +50,7 @@
 #include "qdma/pcie_driver_handler.hpp"
 #include "qdma/qdma_connection.hpp"
 #include "qdma/qdma_intf.hpp"
+#include "utils/io_engine.hpp"
 #include "utils/logger.hpp"
 #include "utils/platform.hpp"
 #include "utils/zmq_server.hpp"
@@ -76,6 +81,18 @@ enum class ProgramType {
  */
 #define QDMA_SETUP_QUEUES "/usr/local/vrt/setup_queues.sh "
 
+/**
+ * @brief Name of the stored transfer engine configuration.
+ *
+ * The file is kept in the per-device directory below AMI_HOME, next to the system map.
+ */
+#define TRANSFER_CONFIG_FILE "transfer_config.json"
+
+/**
+ * @brief Default size of the scratch region used for transfer calibration (256 MiB).
+ */
+#define TRANSFER_CALIBRATION_SIZE (256UL << 20)
+
 /**
  * @brief Delay in microseconds for partial boot process.
  *
@@ -102,14 +119,17 @@ class Device {
     ClkWiz clkWiz;            ///< Clock Wizard object for handling clock wizard operations
     uint64_t clockFreq;       ///< Clock frequency
     ProgramType programType;  ///< Type of programming
-    std::map<std::string, Kernel> kernels;        ///< Map of kernel names to Kernel objects
-    PcieDriverHandler pcieHandler;                ///< PCIe driver handler object
-    Allocator* allocator;                         ///< Allocator object
-    VrtbinType vrtbinType;                        ///< Type of VRTBIN
-    Platform platform;                            ///< Platform information
-    std::shared_ptr<ZmqServer> zmqServer;         ///< ZeroMQ server object
-    std::vector<QdmaConnection> qdmaConnections;  ///< Vector of QDMA connections
-    std::vector<QdmaIntf*> qdmaIntfs;             ///< Vector of QDMA interfaces for streaming
+    std::map<std::string, Kernel> kernels;         ///< Map of kernel names to Kernel objects
+    PcieDriverHandler pcieHandler;                 ///< PCIe driver handler object
+    Allocator* allocator;                          ///< Allocator object
+    VrtbinType vrtbinType;                         ///< Type of VRTBIN
+    Platform platform;                             ///< Platform information
+    std::shared_ptr<ZmqServer> zmqServer;          ///< ZeroMQ server object
+    std::vector<QdmaConnection> qdmaConnections;   ///< Vector of QDMA connections
+    std::vector<QdmaIntf*> qdmaIntfs;              ///< Vector of QDMA interfaces for streaming
+    std::shared_ptr<IoEngine> ioEngine;            ///< I/O engine for asynchronous transfers
+    std::shared_ptr<HostAllocator> hostAllocator;  ///< Allocator for host buffer memory
+    std::shared_ptr<QdmaLogic> qdmaLogic;          ///< QDMA logic setting C2H packet lengths
    public:
     QdmaIntf qdmaIntf;  ///< QDMA interface object
 
@@ -147,6 +167,17 @@ class Device {
      */
     void sendPcieDriverCmd(std::string cmd);
 
+    /**
+     * @brief Gets the path of the stored transfer engine configuration.
+     * @return The path of the configuration file.
+     */
+    std::string getTransferConfigPath();
+
+    /**
+     * @brief Loads the stored transfer engine configuration, if there is one.
+     */
+    void loadTransferConfig();
+
     /**
      * @brief Boots the device.
      */
@@ -221,26 +252,86 @@ class Device {
      */
     std::shared_ptr<ZmqServer> getZmqServer();
 
+    /**
+     * @brief Gets the I/O engine executing asynchronous transfers.
+     */
+    std::shared_ptr<IoEngine> getIoEngine();
+
+    /**
+     * @brief Gets the allocator for host buffer memory.
+     */
+    std::shared_ptr<HostAllocator> getHostAllocator() const;
+
     /**
      * @brief Gets the Allocator instance.
      */
     Allocator* getAllocator();
 
+    /**
+     * @brief Gets a snapshot of the device memory statistics.
+     *
+     * While the device is open, the same counters can be watched with `v80-smi memstat`.
+     */
+    MemoryStats getMemoryStats() const;
+
+    /**
+     * @brief Starts several kernels as close to simultaneously as possible.
+     *
+     * The argument blocks of all launches are written first, then the start bits are set
+     * back-to-back, so the start skew between the kernels is a few register writes:
+     * @code
+     * device.launchMany({vadd0.bind(n, a.getPhysAddr()), vadd1.bind(n, b.getPhysAddr())});
+     * @endcode
+     * @param launches The launches created by Kernel::bind(), each for a different kernel.
+     */
+    void launchMany(const std::vector<KernelLaunch>& launches);
+
     /**
      * @brief Gets the QDMA connections.
      */
     std::vector<QdmaConnection> getQdmaConnections();
 
-    // /**
-    //  * @brief Gets the QDMA logic instance.
-    //  */
-    // QdmaLogic* getQdmaLogic();
+    /**
+     * @brief Gets the QDMA logic instance. Only available on hardware.
+     */
+    std::shared_ptr<QdmaLogic> getQdmaLogic();
 
     /**
      * @brief Gets the QDMA streaming interfaces.
      */
     std::vector<QdmaIntf*> getQdmaInterfaces();
 
+    /**
+     * @brief Calibrates the transfer engine and stores the result for this device.
+     *
+     * Chunk sizes and in-flight depths are measured on a scratch region of device memory. The
+     * best setting is applied and saved next to the system map, so later sessions on the same
+     * BDF load it at startup.
+     *
+     * @param scratchSize The size of the scratch region in bytes.
+     * @return The applied configuration.
+     * @throws std::runtime_error If the device is not a hardware device.
+     */
+    QdmaTransferConfig calibrateTransfers(uint64_t scratchSize = TRANSFER_CALIBRATION_SIZE);
+
+    /**
+     * @brief Synchronizes several buffers in one batch.
+     *
+     * On hardware the ranges of all buffers are spread across the MM queues and the call waits
+     * once for all of them. In emulation all buffers are exchanged in a single request. Other
+     * platforms synchronize the buffers one after another.
+     *
+     * @param buffers The buffers to synchronize.
+     * @param syncType The type of synchronization.
+     * @throws std::invalid_argument If a buffer pointer is null.
+     */
+    void syncAll(const std::vector<BufferBase*>& buffers, SyncType syncType);
+
+    /**
+     * @brief Shares the allocator statistics with v80-smi through a shared memory segment.
+     */
+    void shareMemoryStats();
+
     /**
      * @brief Locks pcie device, for exclusive access.
      */
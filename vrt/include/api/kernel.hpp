@@ -25,15 +25,17 @@
 #include <ami_mem_access.h>
 #include <json/json.h>
 
+#include <chrono>
 #include <iostream>
+#include <map>
 #include <memory>
-#include <regex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <vector>
 
 #include "register/register.hpp"
+#include "utils/adaptive_poller.hpp"
 #include "utils/logger.hpp"
 #include "utils/platform.hpp"
 #include "utils/zmq_server.hpp"
@@ -43,22 +45,87 @@ class Device;
 template <typename T>
 class Buffer;
 
+/**
+ * @brief Struct describing the control registers of one kernel argument.
+ *
+ * Pointers and 64 bit scalars occupy two registers whose names end in _<n>, all other
+ * arguments one.
+ */
+struct ArgumentSlot {
+    uint32_t offset;           ///< Offset of the (low) register
+    uint32_t highOffset;       ///< Offset of the high register of a wide argument
+    bool wide;                 ///< Flag indicating whether the argument spans two registers
+    std::string emulatorName;  ///< Name of the argument in emulation commands
+};
+
+class Kernel;
+
+/**
+ * @brief A kernel invocation whose arguments are staged but which is not started yet.
+ *
+ * Created by Kernel::bind() and started together with others by Device::launchMany().
+ */
+struct KernelLaunch {
+    Kernel* kernel;        ///< Kernel to start
+    Json::Value command;   ///< Emulation command carrying the arguments
+};
+
 /**
  * @brief Class representing a kernel.
  */
 class Kernel {
+    friend class Device;
+
     static constexpr uint64_t BASE_BAR_ADDR = 0x20100000000;  ///< Base BAR address
+    static constexpr uint32_t AP_START = 0x01;                ///< Control bit: start requested
+    static constexpr uint32_t AP_IDLE = 0x04;                 ///< Control bit: kernel idle
+    static constexpr size_t FIRST_ARGUMENT_REGISTER = 4;      ///< Registers before are control
     uint8_t bar = 0;                                          ///< Base Address Register (BAR)
     ami_device* dev = nullptr;                                ///< Pointer to the AMI device
     std::string name;                                         ///< Name of the kernel
     uint64_t baseAddr;                                        ///< Base address of the kernel
     uint64_t range;                                           ///< Address range of the kernel
     std::vector<Register> registers;                          ///< List of registers in the kernel
-    size_t currentRegisterIndex = 4;           ///< Index of the current register being processed
-    std::string deviceBdf;                     ///< BDF of the device
-    Platform platform;                         ///< Platform of the device
-    std::shared_ptr<ZmqServer> server;         ///< Pointer to ZeroMQ server for communication
-    std::map<uint32_t, uint32_t> registerMap;  ///< Map of register offsets to values
+    std::vector<ArgumentSlot> argumentPlan;      ///< Registers of each argument, in order
+    std::vector<uint32_t> registerValues;        ///< Staged values of all control registers
+    size_t currentArgument = 0;                  ///< Index of the argument being processed
+    std::string deviceBdf;                       ///< BDF of the device
+    Platform platform;                           ///< Platform of the device
+    std::shared_ptr<ZmqServer> server;           ///< Pointer to ZeroMQ server for communication
+    std::map<std::string, uint8_t> memoryPorts;  ///< HBM ports of arguments and interfaces
+    std::chrono::steady_clock::time_point startTime;  ///< Time of the last start
+    std::chrono::nanoseconds expectedRuntime{0};      ///< Moving average of observed runtimes
+    bool runPending = false;                          ///< Last start not yet seen completing
+    bool persistent = false;                          ///< Fed argument sets by pushArguments()
+
+    /**
+     * @brief Records the runtime of the last start once its completion is seen.
+     */
+    void recordCompletion();
+
+    /**
+     * @brief Resolves the registers of every argument from the register list.
+     *
+     * Runs once at construction, so launching only stores integers into registerValues.
+     */
+    void buildArgumentPlan();
+
+    /**
+     * @brief Transfers the arguments staged by bind() to the device.
+     */
+    void writeLaunchArguments();
+
+    /**
+     * @brief Starts a launch whose arguments were already transferred.
+     * @param launch The launch created by bind().
+     */
+    void fireLaunch(const KernelLaunch& launch);
+
+    /**
+     * @brief Writes the staged argument registers, leaving the control registers untouched.
+     */
+    void writeArgumentRegisters();
+
    public:
     /**
      * @brief Constructor for Kernel.
@@ -103,11 +170,61 @@ class Kernel {
      */
     uint32_t read(uint32_t offset);
 
+    /// Timeout of waits that do not pass one
+    static constexpr std::chrono::nanoseconds WAIT_FOREVER = std::chrono::nanoseconds::max();
+
     /**
      * @brief Waits for the kernel to complete.
+     *
+     * The kernel is polled adaptively: spinning for short runs, sleeping for a part of the
+     * runtime expected from earlier runs, and backing off when a run takes longer.
+     * @throws std::logic_error If the kernel runs persistently.
      */
     void wait();
 
+    /**
+     * @brief Waits for the kernel to complete, at most for the given time.
+     * @param timeout The maximum time to wait.
+     * @return True if the kernel completed, false if the timeout expired.
+     * @throws std::logic_error If the kernel runs persistently.
+     */
+    bool wait(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Checks once whether the kernel has completed.
+     * @return True if the kernel is not running.
+     */
+    bool isDone();
+
+    /**
+     * @brief Gets the time the running start is expected to take until completion.
+     *
+     * The estimate is a moving average of the runtimes observed by earlier waits.
+     *
+     * @return The expected remaining runtime, zero if unknown.
+     */
+    std::chrono::nanoseconds remainingRuntime() const;
+
+    /**
+     * @brief Waits from one thread until any of the kernels completes.
+     * @param kernels The kernels to wait for.
+     * @param timeout The maximum time to wait.
+     * @return The index of a completed kernel, or -1 if the timeout expired.
+     * @throws std::logic_error If one of the kernels runs persistently.
+     */
+    static int waitAny(const std::vector<Kernel*>& kernels,
+                       std::chrono::nanoseconds timeout = WAIT_FOREVER);
+
+    /**
+     * @brief Waits from one thread until all of the kernels complete.
+     * @param kernels The kernels to wait for.
+     * @param timeout The maximum time to wait.
+     * @return True if all kernels completed, false if the timeout expired.
+     * @throws std::logic_error If one of the kernels runs persistently.
+     */
+    static bool waitAll(const std::vector<Kernel*>& kernels,
+                        std::chrono::nanoseconds timeout = WAIT_FOREVER);
+
     /**
      * @brief Starts the kernel.
      * @param autorestart Flag indicating whether to enable autorestart.
@@ -131,7 +248,7 @@ class Kernel {
      */
     template <typename... Args>
     void call(Args... args) {
-        currentRegisterIndex = 4;
+        currentArgument = 0;
         if (platform == Platform::HARDWARE) {
             (processArg(args), ...);
             this->writeBatch();
@@ -141,8 +258,7 @@ class Kernel {
             Json::Value command;
             command["command"] = "call";
             command["function"] = name;
-            int argIdx = 0;
-            (processEmuArg(args, command, argIdx), ...);
+            (processEmuArg(args, command), ...);
             server->sendCommand(command);
         } else if (platform == Platform::SIMULATION) {
             (processSimArg(args), ...);
@@ -157,7 +273,7 @@ class Kernel {
      */
     template <typename... Args>
     void start(Args... args) {
-        currentRegisterIndex = 4;
+        currentArgument = 0;
         if (platform == Platform::HARDWARE) {
             (processArg(args), ...);
             this->writeBatch();
@@ -167,14 +283,128 @@ class Kernel {
             Json::Value command;
             command["command"] = "call";
             command["function"] = name;
-            int argIdx = 0;
-            (processEmuArg(args, command, argIdx), ...);
+            (processEmuArg(args, command), ...);
             server->sendCommand(command);
         } else if (platform == Platform::SIMULATION) {
             (processSimArg(args), ...);
             this->startKernel();
         }
     }
+    /**
+     * @brief Stages the arguments of an invocation without starting the kernel.
+     *
+     * The staged values stay in this kernel until the launch is passed to Device::launchMany(),
+     * so binding the same kernel again replaces them.
+     * @param args The arguments to pass to the kernel.
+     * @return The launch to pass to Device::launchMany().
+     */
+    template <typename... Args>
+    KernelLaunch bind(Args... args) {
+        currentArgument = 0;
+        KernelLaunch launch{this, Json::Value()};
+        if (platform == Platform::HARDWARE) {
+            (processArg(args), ...);
+        } else if (platform == Platform::EMULATION) {
+            launch.command["command"] = "call";
+            launch.command["function"] = name;
+            (processEmuArg(args, launch.command), ...);
+        } else if (platform == Platform::SIMULATION) {
+            (processSimArg(args), ...);
+        }
+        return launch;
+    }
+
+    /**
+     * @brief Starts the kernel in persistent mode.
+     *
+     * The argument registers and the set the kernel latched at its start form two buffers:
+     * while the kernel works on one set, pushArguments() writes the next into the registers and
+     * sets ap_start again. The control adapter clears ap_start when the kernel latches its
+     * inputs (ap_ready), so a cleared ap_start is the acknowledgement that a set was taken. The
+     * host only writes registers while ap_start is clear, and sets it after the whole set is
+     * written, so no set is skipped, overwritten before use or latched half-written.
+     *
+     * Kernels whose ap_ready comes before ap_done (pipelined or dataflow) start the next set
+     * without a launch gap; others start it as soon as they are done. The kernel must use the
+     * default ap_ctrl_hs interface. It stays in this mode until stopPersistent() returns true.
+     * Before, isDone() reports it as running, and wait(), waitAny(), waitAll() and command
+     * queues reject it, since it never completes on its own.
+     *
+     * On emulation, every argument set runs as one call instead.
+     * @param args The arguments of the first iteration.
+     */
+    template <typename... Args>
+    void startPersistent(Args... args) {
+        if (platform == Platform::EMULATION) {
+            start(args...);
+        } else {
+            currentArgument = 0;
+            if (platform == Platform::HARDWARE) {
+                (processArg(args), ...);
+                this->writeBatch();
+            } else {
+                (processSimArg(args), ...);
+            }
+            this->startKernel();
+        }
+        persistent = true;
+    }
+
+    /**
+     * @brief Queues the arguments of the next iteration of a persistent kernel.
+     *
+     * Blocks until the kernel latched the previously pushed set, then writes this set and sets
+     * ap_start.
+     * @param args The arguments of the next iteration.
+     */
+    template <typename... Args>
+    void pushArguments(Args... args) {
+        if (!persistent) {
+            throw std::logic_error("Kernel " + name + " is not running persistently");
+        }
+        if (platform == Platform::EMULATION) {
+            start(args...);
+            return;
+        }
+        waitArgumentsLatched();
+        currentArgument = 0;
+        if (platform == Platform::HARDWARE) {
+            (processArg(args), ...);
+            this->writeArgumentRegisters();
+        } else {
+            (processSimArg(args), ...);
+        }
+        this->startKernel();
+    }
+
+    /**
+     * @brief Waits until a persistent kernel latched the last pushed arguments.
+     * @param timeout The maximum time to wait.
+     * @return True if the next set can be pushed without blocking, false on timeout.
+     */
+    bool waitArgumentsLatched(std::chrono::nanoseconds timeout = WAIT_FOREVER);
+
+    /**
+     * @brief Stops a persistent kernel once it latched the last set and waits until it is idle.
+     */
+    void stopPersistent();
+
+    /**
+     * @brief Stops a persistent kernel, waiting at most for the given time.
+     *
+     * If the timeout expires, the kernel stays persistent, so the call can be repeated.
+     * @param timeout The maximum time to wait for the last set to be latched and the kernel to
+     * become idle.
+     * @return True if the kernel is idle, false if the timeout expired.
+     */
+    bool stopPersistent(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Checks whether the kernel runs persistently.
+     * @return True between startPersistent() and a successful stopPersistent().
+     */
+    bool isPersistent() const;
+
     /**
      * @brief Helper method which processes an argument.
      * @tparam T The type of the argument.
@@ -182,22 +412,15 @@ class Kernel {
      */
     template <typename T>
     void processArg(T arg) {
-        if (currentRegisterIndex < registers.size()) {
-            std::regex re(".*_\\d+$");  // Regular expression to match strings ending with _nr
-            if (std::regex_match(registers.at(currentRegisterIndex).getRegisterName(), re)) {
-                this->registerMap[registers.at(currentRegisterIndex).getOffset()] =
-                    arg & 0xFFFFFFFF;
-                this->registerMap[registers.at(currentRegisterIndex + 1).getOffset()] =
-                    static_cast<uint32_t>((static_cast<uint64_t>(arg) >> 32) & 0xFFFFFFFF);
-                currentRegisterIndex += 2;
-            } else {
-                this->registerMap[registers.at(currentRegisterIndex).getOffset()] = arg;
-                currentRegisterIndex++;
-            }
-
-        } else {
+        if (currentArgument >= argumentPlan.size()) {
             throw std::runtime_error("Not enough registers to process all arguments.");
         }
+        const ArgumentSlot& slot = argumentPlan[currentArgument++];
+        uint64_t value = static_cast<uint64_t>(arg);
+        registerValues[slot.offset / sizeof(uint32_t)] = static_cast<uint32_t>(value);
+        if (slot.wide) {
+            registerValues[slot.highOffset / sizeof(uint32_t)] = static_cast<uint32_t>(value >> 32);
+        }
     }
 
     /**
@@ -207,17 +430,14 @@ class Kernel {
      */
     template <typename T>
     void processSimArg(T arg) {
-        if (currentRegisterIndex < registers.size()) {
-            std::regex re(".*_\\d+$");  // Regular expression to match strings ending with _nr
-            if (std::regex_match(registers.at(currentRegisterIndex).getRegisterName(), re)) {
-                this->write(registers.at(currentRegisterIndex).getOffset(), arg & 0xFFFFFFFF);
-                this->write(registers.at(currentRegisterIndex + 1).getOffset(),
-                            static_cast<uint32_t>((static_cast<uint64_t>(arg) >> 32) & 0xFFFFFFFF));
-                currentRegisterIndex += 2;
-            } else {
-                this->write(registers.at(currentRegisterIndex).getOffset(), arg);
-                currentRegisterIndex++;
-            }
+        if (currentArgument >= argumentPlan.size()) {
+            return;
+        }
+        const ArgumentSlot& slot = argumentPlan[currentArgument++];
+        uint64_t value = static_cast<uint64_t>(arg);
+        this->write(slot.offset, static_cast<uint32_t>(value));
+        if (slot.wide) {
+            this->write(slot.highOffset, static_cast<uint32_t>(value >> 32));
         }
     }
 
@@ -226,25 +446,21 @@ class Kernel {
      * @tparam T The type of the argument.
      * @param arg The argument to process.
      * @param command The JSON command to update.
-     * @param argIndex The index of the argument.
      */
     template <typename T>
-    void processEmuArg(T arg, Json::Value& command, int& argIndex) {
-        if (currentRegisterIndex < registers.size()) {
-            std::regex re(".*_\\d+$");  // Regular expression to match strings ending with _nr
-            if (std::regex_match(registers.at(currentRegisterIndex).getRegisterName(), re)) {
-                command["args"]["arg" + std::to_string(argIndex)]["type"] = "buffer";
-                command["args"]["arg" + std::to_string(argIndex)]["name"] = std::to_string(arg);
-                currentRegisterIndex += 2;
-            } else {
-                command["args"]["arg" + std::to_string(argIndex)]["type"] = "scalar";
-                command["args"]["arg" + std::to_string(argIndex)]["value"] = arg;
-                currentRegisterIndex++;
-            }
-            argIndex++;
-        } else {
+    void processEmuArg(T arg, Json::Value& command) {
+        if (currentArgument >= argumentPlan.size()) {
             throw std::runtime_error("Not enough registers to process all arguments.");
         }
+        const ArgumentSlot& slot = argumentPlan[currentArgument++];
+        Json::Value& entry = command["args"][slot.emulatorName];
+        if (slot.wide) {
+            entry["type"] = "buffer";
+            entry["name"] = std::to_string(arg);
+        } else {
+            entry["type"] = "scalar";
+            entry["value"] = arg;
+        }
     }
 
     /**
@@ -253,6 +469,28 @@ class Kernel {
      */
     std::string getName() const;
 
+    /**
+     * @brief Records the HBM port an argument or AXI-MM interface is attached to.
+     * @param name The name of the kernel argument or interface.
+     * @param port The HBM port (pseudo-channel) number.
+     */
+    void setMemoryPort(const std::string& name, uint8_t port);
+
+    /**
+     * @brief Checks if the HBM port of an argument or interface is known.
+     * @param name The name of the kernel argument or interface.
+     * @return True if the system map assigns a port to it.
+     */
+    bool hasMemoryPort(const std::string& name) const;
+
+    /**
+     * @brief Gets the HBM port an argument or AXI-MM interface is attached to.
+     * @param name The name of the kernel argument or interface.
+     * @return The HBM port (pseudo-channel) number.
+     * @throws std::out_of_range If the system map does not assign a port to it.
+     */
+    uint8_t getMemoryPort(const std::string& name) const;
+
     /**
      * @brief Destructor for Kernel.
      */
@@ -277,11 +515,17 @@ class Kernel {
           baseAddr(other.baseAddr),
           range(other.range),
           registers(std::move(other.registers)),
-          currentRegisterIndex(other.currentRegisterIndex),
+          argumentPlan(std::move(other.argumentPlan)),
+          registerValues(std::move(other.registerValues)),
+          currentArgument(other.currentArgument),
           deviceBdf(std::move(other.deviceBdf)),
           platform(other.platform),
           server(std::move(other.server)),
-          registerMap(std::move(other.registerMap)) {}
+          memoryPorts(std::move(other.memoryPorts)),
+          startTime(other.startTime),
+          expectedRuntime(other.expectedRuntime),
+          runPending(other.runPending),
+          persistent(other.persistent) {}
 
     /**
      * @brief Copy assignment operator.
@@ -305,11 +549,17 @@ class Kernel {
             baseAddr = other.baseAddr;
             range = other.range;
             registers = std::move(other.registers);
-            currentRegisterIndex = other.currentRegisterIndex;
+            argumentPlan = std::move(other.argumentPlan);
+            registerValues = std::move(other.registerValues);
+            currentArgument = other.currentArgument;
             deviceBdf = std::move(other.deviceBdf);
             platform = other.platform;
             server = std::move(other.server);
-            registerMap = std::move(other.registerMap);
+            memoryPorts = std::move(other.memoryPorts);
+            startTime = other.startTime;
+            expectedRuntime = other.expectedRuntime;
+            runPending = other.runPending;
+            persistent = other.persistent;
         }
         return *this;
     }
@@ -0,0 +1,287 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef QUEUE_HPP
+#define QUEUE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "api/buffer_base.hpp"
+#include "api/device.hpp"
+#include "api/kernel.hpp"
+#include "utils/io_engine.hpp"
+
+namespace vrt {
+
+class Queue;
+
+/**
+ * @brief Enum class representing the ordering of a command queue.
+ */
+enum class QueueMode {
+    IN_ORDER,      ///< Every command waits for the previous one
+    OUT_OF_ORDER,  ///< Commands wait only for their explicit and inferred dependencies
+};
+
+/**
+ * @brief Struct representing one command of a queue and its place in the dependency graph.
+ */
+struct QueueCommand {
+    std::function<void()> action;                           ///< Work of the command
+    Kernel* kernel = nullptr;                               ///< Kernel ending the command, if any
+    std::size_t pendingDependencies = 0;                    ///< Dependencies not yet complete
+    std::vector<std::shared_ptr<QueueCommand>> dependents;  ///< Commands waiting for this one
+    bool done = false;                                      ///< Set when the command completed
+    std::exception_ptr error;                               ///< Error of the command, if any
+    std::promise<void> promise;                             ///< Fulfilled on completion
+    const Queue* queue = nullptr;                           ///< Queue owning the command
+};
+
+/**
+ * @brief Class representing the completion of a queued command.
+ */
+class QueueEvent {
+    std::shared_ptr<QueueCommand> command;  ///< The command, kept alive for dependents
+    std::shared_future<void> future;        ///< Completion of the command
+
+    friend class Queue;
+
+   public:
+    /**
+     * @brief Default constructor. The event is already complete.
+     */
+    QueueEvent() = default;
+
+    /**
+     * @brief Constructor for QueueEvent.
+     * @param command The command the event refers to.
+     */
+    explicit QueueEvent(std::shared_ptr<QueueCommand> command);
+
+    /**
+     * @brief Blocks until the command has completed.
+     * @throws Any exception raised by the command or a command it depends on.
+     */
+    void wait() const;
+
+    /**
+     * @brief Checks whether the command has completed without blocking.
+     * @return True if the command has completed.
+     */
+    bool ready() const;
+};
+
+/**
+ * @brief Class implementing a command queue with a dependency graph.
+ *
+ * Buffer synchronizations, kernel launches and host callbacks are enqueued as commands. A command
+ * is issued as soon as the commands it depends on have completed, so independent transfers and
+ * kernels run concurrently. Transfers, kernel starts and callbacks run on the I/O engine of the
+ * device; the completion of running kernels is detected by one monitor thread per queue, so no
+ * thread is blocked per kernel.
+ *
+ * In out-of-order mode a command depends on the events passed to it and on the last earlier
+ * command that used the same buffer or kernel. Buffers passed as kernel arguments count as used
+ * and are replaced by their physical address. Host callbacks only have explicit dependencies.
+ * If a command fails, the commands depending on it are skipped and carry its error.
+ *
+ * Kernels and buffers used by queued commands must not be accessed directly until the commands
+ * have completed. The same holds on the emulation platform, where the queue works unchanged.
+ */
+class Queue {
+   public:
+    /**
+     * @brief Constructor for Queue.
+     * @param device The device the commands are executed on.
+     * @param mode The ordering of the queue.
+     */
+    Queue(Device device, QueueMode mode = QueueMode::IN_ORDER);
+
+    /**
+     * @brief Destructor for Queue. Waits for all commands to complete.
+     */
+    ~Queue();
+
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+
+    /**
+     * @brief Enqueues the synchronization of a buffer.
+     * @param buffer The buffer to synchronize.
+     * @param syncType The direction of the synchronization.
+     * @return The event of the command.
+     */
+    QueueEvent enqueueSync(BufferBase& buffer, SyncType syncType);
+
+    /**
+     * @brief Enqueues the synchronization of a buffer after other commands.
+     * @param dependencies The events the command waits for.
+     * @param buffer The buffer to synchronize.
+     * @param syncType The direction of the synchronization.
+     * @return The event of the command.
+     */
+    QueueEvent enqueueSync(const std::vector<QueueEvent>& dependencies, BufferBase& buffer,
+                           SyncType syncType);
+
+    /**
+     * @brief Enqueues a kernel launch. The command completes when the kernel has finished.
+     * @param kernel The kernel to launch.
+     * @param args The kernel arguments; buffers are passed by their physical address.
+     * @return The event of the command.
+     * @throws std::logic_error If the kernel runs persistently.
+     */
+    template <typename... Args>
+    QueueEvent enqueueKernel(Kernel& kernel, Args&&... args) {
+        return enqueueKernel({}, kernel, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Enqueues a kernel launch after other commands.
+     * @param dependencies The events the command waits for.
+     * @param kernel The kernel to launch.
+     * @param args The kernel arguments; buffers are passed by their physical address.
+     * @return The event of the command.
+     * @throws std::logic_error If the kernel runs persistently. A kernel made persistent
+     * before the command runs fails the command instead.
+     */
+    template <typename... Args>
+    QueueEvent enqueueKernel(const std::vector<QueueEvent>& dependencies, Kernel& kernel,
+                             Args&&... args) {
+        // a persistent kernel never completes, the command would block the queue for good
+        if (kernel.isPersistent()) {
+            throw std::logic_error("Cannot enqueue persistent kernel " + kernel.getName());
+        }
+        std::vector<const void*> resources{&kernel};
+        auto values = std::make_tuple(resolveArgument(std::forward<Args>(args), resources)...);
+        auto command = std::make_shared<QueueCommand>();
+        command->kernel = &kernel;
+        command->action = [&kernel, values]() {
+            if (kernel.isPersistent()) {
+                throw std::logic_error("Cannot launch persistent kernel " + kernel.getName());
+            }
+            std::apply([&kernel](auto... value) { kernel.start(value...); }, values);
+        };
+        return enqueue(command, dependencies, resources);
+    }
+
+    /**
+     * @brief Enqueues a host callback.
+     * @param callback The function to run on the host.
+     * @return The event of the command.
+     */
+    QueueEvent enqueueCallback(std::function<void()> callback);
+
+    /**
+     * @brief Enqueues a host callback after other commands.
+     * @param dependencies The events the command waits for.
+     * @param callback The function to run on the host.
+     * @return The event of the command.
+     */
+    QueueEvent enqueueCallback(const std::vector<QueueEvent>& dependencies,
+                               std::function<void()> callback);
+
+    /**
+     * @brief Waits until all enqueued commands have completed.
+     * @throws The first error raised by a command since the last finish().
+     */
+    void finish();
+
+    /**
+     * @brief Gets the ordering of the queue.
+     * @return The mode of the queue.
+     */
+    QueueMode getMode() const;
+
+   private:
+    /**
+     * @brief Replaces a buffer argument by its physical address and records its use.
+     */
+    template <typename A>
+    static auto resolveArgument(A&& arg, std::vector<const void*>& resources) {
+        if constexpr (std::is_base_of_v<BufferBase, std::decay_t<A>>) {
+            resources.push_back(static_cast<const BufferBase*>(&arg));
+            return arg.getPhysAddr();
+        } else {
+            return std::decay_t<A>(std::forward<A>(arg));
+        }
+    }
+
+    /**
+     * @brief Adds a command to the dependency graph and issues it if it is ready.
+     * @param command The command.
+     * @param dependencies The explicit dependencies.
+     * @param resources The buffers and kernels used by the command.
+     * @return The event of the command.
+     */
+    QueueEvent enqueue(const std::shared_ptr<QueueCommand>& command,
+                       const std::vector<QueueEvent>& dependencies,
+                       const std::vector<const void*>& resources);
+
+    /**
+     * @brief Runs the action of a ready command on the I/O engine.
+     * @param command The command.
+     */
+    void issue(const std::shared_ptr<QueueCommand>& command);
+
+    /**
+     * @brief Marks a command complete and issues the dependents that became ready.
+     * @param command The command.
+     * @param error The error of the command, if any.
+     */
+    void complete(const std::shared_ptr<QueueCommand>& command, std::exception_ptr error);
+
+    /**
+     * @brief Main loop of the thread detecting the completion of running kernels.
+     */
+    void monitorLoop();
+
+    Device device;                              ///< The device of the queue
+    QueueMode mode;                             ///< The ordering of the queue
+    std::shared_ptr<IoEngine> engine;           ///< Engine running the commands
+    std::mutex mutex;                           ///< Guards the dependency graph
+    std::condition_variable condition;          ///< Signals completions and kernels
+    std::shared_ptr<QueueCommand> lastCommand;  ///< Last command, for in-order mode
+    std::map<const void*, std::shared_ptr<QueueCommand>>
+        lastUse;  ///< Last command using each buffer or kernel
+    std::vector<std::shared_ptr<QueueCommand>> runningKernels;  ///< Started, not completed
+    std::size_t outstanding = 0;                                ///< Commands not yet completed
+    std::exception_ptr firstError;                              ///< First error since finish()
+    bool stopping = false;                                      ///< Set when the queue shuts down
+    std::thread monitor;                                        ///< Thread polling running kernels
+};
+
+}  // namespace vrt
+
+#endif  // QUEUE_HPP
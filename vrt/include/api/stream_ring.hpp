@@ -0,0 +1,189 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef STREAM_RING_HPP
+#define STREAM_RING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "api/device.hpp"
+#include "qdma/qdma_connection.hpp"
+#include "qdma/qdma_intf.hpp"
+
+namespace vrt {
+
+/**
+ * @brief Class representing a continuous producer/consumer ring on a QDMA stream queue.
+ *
+ * The ring owns a fixed number of host slots and a background thread that keeps the stream
+ * queue busy. For H2C rings the application acquires an empty slot, fills it and commits it;
+ * the thread sends it and hands the slot back. For C2H rings the thread fills slots from the
+ * queue; the application acquires a filled slot, consumes it and commits it to be refilled.
+ * acquire() blocks while no slot is available, which provides backpressure in both directions.
+ *
+ * In emulation slots are exchanged through the stream_in/stream_out commands, so slot sizes
+ * must be a multiple of the 64-byte stream word.
+ */
+class StreamRing {
+   public:
+    /// Default number of host slots
+    static constexpr std::size_t DEFAULT_SLOTS = 8;
+
+    /**
+     * @brief Struct representing a slot handed to the application.
+     */
+    struct Slot {
+        char* data;        ///< Host memory of the slot
+        std::size_t size;  ///< Valid bytes, the received bytes for C2H rings
+        std::size_t id;    ///< Index of the slot inside the ring
+    };
+
+    /**
+     * @brief Constructor for StreamRing.
+     * @param device VRT Device of the ring.
+     * @param kernel The kernel the stream is connected to.
+     * @param portName The name of the stream port.
+     * @param slotSize The size of each slot in bytes.
+     * @param slotCount The number of slots.
+     * @throws std::runtime_error If there is no QDMA connection for the port.
+     */
+    StreamRing(Device device, Kernel kernel, const std::string& portName, std::size_t slotSize,
+               std::size_t slotCount = DEFAULT_SLOTS);
+
+    /**
+     * @brief Destructor for StreamRing. Stops the thread, waiting for an in-flight transfer.
+     */
+    ~StreamRing();
+
+    StreamRing(const StreamRing&) = delete;
+    StreamRing& operator=(const StreamRing&) = delete;
+
+    /**
+     * @brief Starts the background thread. Called implicitly by acquire() and commit().
+     *
+     * A C2H ring starts draining the queue right away, so it is usually started after the
+     * kernel feeding it has been launched.
+     */
+    void start();
+
+    /**
+     * @brief Stops the background thread. Committed slots stay queued until the next start.
+     *
+     * A C2H thread waiting for a packet is interrupted, and the partly filled slot is handed to
+     * the application. If the queue driver does not support poll, the pending read cannot be
+     * interrupted and stop() returns once the next packet arrives or the driver's request times
+     * out.
+     */
+    void stop();
+
+    /**
+     * @brief Acquires a slot, blocking until one is available.
+     * @return An empty slot for H2C rings, a filled slot for C2H rings.
+     * @throws The error of the background thread, if it failed.
+     */
+    Slot acquire();
+
+    /**
+     * @brief Acquires a slot, blocking at most for a timeout.
+     * @param slot The acquired slot.
+     * @param timeout The maximum time to wait.
+     * @return True if a slot was acquired.
+     */
+    bool acquireFor(Slot& slot, std::chrono::microseconds timeout);
+
+    /**
+     * @brief Hands a slot back to the background thread.
+     * @param slot The slot to commit.
+     * @param bytes The number of bytes to send, ignored for C2H rings.
+     */
+    void commit(const Slot& slot, std::size_t bytes);
+
+    /**
+     * @brief Hands a slot back to the background thread, sending all bytes for H2C rings.
+     * @param slot The slot to commit.
+     */
+    void commit(const Slot& slot);
+
+    /**
+     * @brief Waits until every committed H2C slot has been sent.
+     */
+    void flush();
+
+    /**
+     * @brief Gets the direction of the stream.
+     * @return The stream direction.
+     */
+    StreamDirection getDirection() const;
+
+    /**
+     * @brief Gets the number of bytes moved by the background thread.
+     * @return The number of bytes transferred.
+     */
+    uint64_t getTransferredBytes() const;
+
+   private:
+    /**
+     * @brief Background thread loop.
+     */
+    void run();
+
+    /**
+     * @brief Transfers one slot on the stream queue.
+     * @param slot The slot to transfer.
+     * @return The number of bytes transferred.
+     */
+    std::size_t transfer(Slot& slot);
+
+    /**
+     * @brief Rethrows the error of the background thread, if any. Expects the mutex held.
+     */
+    void checkError();
+
+    Device device;                         ///< VRT Device of the ring
+    StreamDirection direction;             ///< Direction of the stream
+    uint32_t qid = 0;                      ///< Stream queue id
+    std::string name;                      ///< Stream name in emulation
+    QdmaIntf* qdmaInterface = nullptr;     ///< Stream queue interface on hardware
+    std::size_t slotSize;                  ///< Size of each slot in bytes
+    char* memory = nullptr;                ///< Host memory of all slots
+    std::deque<Slot> appSlots;             ///< Slots available to acquire()
+    std::deque<Slot> workSlots;            ///< Slots waiting for the background thread
+    std::size_t busySlots = 0;             ///< Slots currently transferred by the thread
+    uint64_t transferredBytes = 0;         ///< Bytes moved by the thread
+    std::exception_ptr error;              ///< Error of the background thread
+    bool running = false;                  ///< Flag indicating the thread runs
+    bool stopping = false;                 ///< Flag asking the thread to stop
+    std::atomic<bool> interrupted{false};  ///< Abandons a pending packet read on stop
+    mutable std::mutex mutex;              ///< Guards the slot queues and flags
+    std::condition_variable cv;            ///< Signals slot and state changes
+    std::thread worker;                    ///< Background thread
+};
+
+}  // namespace vrt
+
+#endif  // STREAM_RING_HPP
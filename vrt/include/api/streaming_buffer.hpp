@@ -24,6 +24,7 @@
 #include <regex>
 
 #include "api/device.hpp"
+#include "driver/qdma_logic.hpp"
 #include "qdma/qdma_connection.hpp"
 #include "qdma/qdma_intf.hpp"
 #include "utils/platform.hpp"
@@ -35,7 +36,9 @@ namespace vrt {
  * @brief Class representing a streaming buffer.
  *
  * This class provides an interface for managing a streaming buffer in a device.
- * It supports streaming QDMA connections.
+ * It supports streaming QDMA connections. On hardware, C2H data arrives in packets whose length
+ * is programmed through the QDMA logic. Packets are received into a ring of host buffers and
+ * copied out while the next packet is read.
  *
  * @tparam T The type of the elements in the buffer.
  */
@@ -94,16 +97,43 @@ class StreamingBuffer {
      */
     void sync();
 
+    /**
+     * @brief Gets the number of bytes received by the last C2H synchronization.
+     *
+     * The count is smaller than the buffer if the stream ended early.
+     *
+     * @return The number of bytes received.
+     */
+    size_t getReceivedBytes() const;
+
+    /**
+     * @brief Sets the length of the packets requested from a C2H stream on hardware.
+     * @param packetSize The packet length in bytes.
+     * @throws std::invalid_argument If the length is 0 or exceeds QDMA_ST_MAX_PACKET_SIZE.
+     */
+    void setPacketSize(uint32_t packetSize);
+
    private:
-    T* localBuffer;            ///< Pointer to the local buffer.
-    size_t size;               ///< Size of the buffer.
-    StreamDirection syncType;  ///< Synchronization type (direction).
-    Device device;             ///< Device associated with the buffer.
-    Kernel kernel;             ///< Kernel associated with the buffer.
-    std::size_t index;         ///< Index of the buffer.
-    std::string name;          ///< Name of the buffer.
-    std::string portName;      ///< Name of the port associated with the buffer.
-    QdmaIntf* qdmaInterface;   ///< Pointer to the QDMA interface.
+    /**
+     * @brief Receives a C2H stream on hardware through the packet ring.
+     *
+     * Packets are copied out by a worker of this buffer while the next one is read. The device
+     * I/O engine is not used, so receive() may run inside one of its tasks.
+     */
+    void receive();
+
+    T* localBuffer;                             ///< Pointer to the local buffer.
+    size_t size;                                ///< Size of the buffer.
+    StreamDirection syncType;                   ///< Synchronization type (direction).
+    Device device;                              ///< Device associated with the buffer.
+    Kernel kernel;                              ///< Kernel associated with the buffer.
+    std::size_t index;                          ///< Index of the buffer.
+    std::string name;                           ///< Name of the buffer.
+    std::string portName;                       ///< Name of the port associated with the buffer.
+    QdmaIntf* qdmaInterface = nullptr;          ///< Pointer to the QDMA interface.
+    size_t receivedBytes = 0;                   ///< Bytes received by the last C2H sync.
+    uint32_t packetSize = QDMA_ST_PACKET_SIZE;  ///< Packet length of C2H streams.
+    std::shared_ptr<IoEngine> copyEngine;       ///< Worker copying packets out of the ring.
 };
 
 template <typename T>
@@ -162,7 +192,7 @@ template <typename T>
 void StreamingBuffer<T>::sync() {
     Platform platform = device.getPlatform();
     if (platform == Platform::EMULATION) {
-        ZmqServer* server = device.getZmqServer();
+        std::shared_ptr<ZmqServer> server = device.getZmqServer();
         if (syncType == StreamDirection::HOST_TO_DEVICE) {
             std::vector<uint8_t> sendData;
             std::size_t dataSize = size * sizeof(T);
@@ -171,21 +201,95 @@ void StreamingBuffer<T>::sync() {
             server->sendStream(name, sendData);
         } else {
             std::vector<uint8_t> recvData = server->fetchStream(name, size * sizeof(T));
-            size = recvData.size() / sizeof(T);
-            localBuffer = reinterpret_cast<T*>(realloc(localBuffer, recvData.size()));
+            size_t count = recvData.size() / sizeof(T);
+            if (count > size) {
+                delete[] localBuffer;
+                localBuffer = new T[count];
+            }
+            size = count;
             std::memcpy(localBuffer, recvData.data(), recvData.size());
+            receivedBytes = recvData.size();
         }
     } else if (platform == Platform::HARDWARE) {
+        if (qdmaInterface == nullptr) {
+            throw std::runtime_error("No QDMA interface for queue " + std::to_string(index));
+        }
         if (syncType == StreamDirection::HOST_TO_DEVICE) {
             qdmaInterface->write_buff(reinterpret_cast<char*>(localBuffer), 0, size * sizeof(T));
         } else {
-            throw std::runtime_error("C2H streaming buffer not implemented in hardware.");
+            receive();
         }
     } else {
         throw std::runtime_error("Streaming buffer not implemented for this platform.");
     }
 }
 
+template <typename T>
+void StreamingBuffer<T>::receive() {
+    std::shared_ptr<QdmaLogic> logic = device.getQdmaLogic();
+    std::shared_ptr<HostAllocator> allocator = device.getHostAllocator();
+    if (!copyEngine) {
+        copyEngine = std::make_shared<IoEngine>(1);
+    }
+    uint64_t totalSize = size * sizeof(T);
+    char* ring = static_cast<char*>(allocator->allocate(QDMA_ST_RING_SLOTS * packetSize));
+    char* dst = reinterpret_cast<char*>(localBuffer);
+    std::shared_future<void> copies[QDMA_ST_RING_SLOTS];
+
+    receivedBytes = 0;
+    std::exception_ptr error;
+    try {
+        for (uint64_t packet = 0; receivedBytes < totalSize; packet++) {
+            char* slot = ring + (packet % QDMA_ST_RING_SLOTS) * packetSize;
+            std::shared_future<void>& copy = copies[packet % QDMA_ST_RING_SLOTS];
+            // the slot is reused once its previous packet has been copied out
+            if (copy.valid()) {
+                copy.get();
+            }
+            uint32_t length = std::min<uint64_t>(packetSize, totalSize - receivedBytes);
+            logic->setValues(index, length);
+            uint64_t bytes = qdmaInterface->read_packet(slot, length);
+            uint64_t offset = receivedBytes;
+            copy = copyEngine->submit(
+                [dst, offset, slot, bytes]() { std::memcpy(dst + offset, slot, bytes); });
+            receivedBytes += bytes;
+            if (bytes < length) {
+                utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                                   "Stream {} ended after {} bytes", name, receivedBytes);
+                break;
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& copy : copies) {
+        if (copy.valid()) {
+            try {
+                copy.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+    allocator->deallocate(ring);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename T>
+size_t StreamingBuffer<T>::getReceivedBytes() const {
+    return receivedBytes;
+}
+
+template <typename T>
+void StreamingBuffer<T>::setPacketSize(uint32_t packetSize) {
+    if (packetSize == 0 || packetSize > QDMA_ST_MAX_PACKET_SIZE) {
+        throw std::invalid_argument("Invalid packet size");
+    }
+    this->packetSize = packetSize;
+}
+
 template <typename T>
 std::string StreamingBuffer<T>::getName() const {
     return name;
@@ -0,0 +1,131 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef SYNC_EVENT_HPP
+#define SYNC_EVENT_HPP
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/io_engine.hpp"
+
+namespace vrt {
+
+/**
+ * @brief Class representing the completion of an asynchronous operation.
+ *
+ * A SyncEvent is returned by the asynchronous buffer API. It can be waited on, polled, or
+ * chained with a continuation that runs on the I/O engine once the operation has completed.
+ * Copies of an event refer to the same operation.
+ */
+class SyncEvent {
+    /**
+     * @brief Completion state shared by all copies of an event.
+     */
+    struct State {
+        std::mutex mutex;            ///< Guards done, error and continuations
+        bool done = false;           ///< Set once the operation has completed
+        std::exception_ptr error;    ///< Error of the operation, if any
+        std::vector<std::function<void(std::exception_ptr)>>
+            continuations;           ///< Started with the error once the operation completes
+        std::promise<void> promise;  ///< Fulfilled once the operation completes
+    };
+
+    std::shared_ptr<State> state;      ///< Completion state, null for a complete event
+    std::shared_future<void> future;   ///< Future of the underlying operation
+    std::shared_ptr<IoEngine> engine;  ///< Engine executing the operation and its continuations
+
+    /**
+     * @brief Constructor for SyncEvent.
+     * @param state The completion state of the operation.
+     * @param engine The engine executing the operation.
+     */
+    SyncEvent(std::shared_ptr<State> state, std::shared_ptr<IoEngine> engine);
+
+    /**
+     * @brief Runs an operation and completes its state.
+     * @param state The completion state of the operation.
+     * @param task The operation.
+     */
+    static void run(const std::shared_ptr<State>& state, const std::function<void()>& task);
+
+    /**
+     * @brief Marks an operation complete and starts its continuations.
+     * @param state The completion state of the operation.
+     * @param error The error of the operation, null on success.
+     */
+    static void complete(const std::shared_ptr<State>& state, std::exception_ptr error);
+
+   public:
+    /**
+     * @brief Default constructor. The event is already complete.
+     */
+    SyncEvent() = default;
+
+    /**
+     * @brief Runs an operation on an engine.
+     * @param engine The engine executing the operation.
+     * @param task The operation.
+     * @return An event that completes when the operation has run.
+     */
+    static SyncEvent submit(std::shared_ptr<IoEngine> engine, std::function<void()> task);
+
+    /**
+     * @brief Blocks until the operation has completed.
+     * @throws Any exception raised by the operation.
+     */
+    void wait() const;
+
+    /**
+     * @brief Blocks until the operation has completed or the timeout expires.
+     * @param timeout The maximum time to wait.
+     * @return True if the operation has completed.
+     */
+    bool waitFor(std::chrono::microseconds timeout) const;
+
+    /**
+     * @brief Checks whether the operation has completed without blocking.
+     * @return True if the operation has completed.
+     */
+    bool ready() const;
+
+    /**
+     * @brief Chains a continuation to the operation.
+     *
+     * The continuation is submitted to the I/O engine when the operation completes successfully,
+     * so it occupies no worker while waiting. If the operation fails, the continuation is
+     * skipped and the returned event carries the error. A default-constructed event has no
+     * engine; its continuation runs at once on the calling thread, and errors it throws are
+     * likewise carried by the returned event instead of propagating to the caller.
+     *
+     * @param continuation The function to execute.
+     * @return An event that completes when the continuation has run.
+     */
+    SyncEvent then(std::function<void()> continuation) const;
+};
+
+}  // namespace vrt
+
+#endif  // SYNC_EVENT_HPP
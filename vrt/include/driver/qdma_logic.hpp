@@ -29,8 +29,7 @@ namespace vrt {
  *
  * The QdmaLogic class extends the Kernel class to provide functionality specific
  * to QDMA operations, allowing for control of QDMA queues and data transfers in streaming mode.
- * 
- * @note Not used now. Might be needed for C2H stream future development
+ * It sets the length of the next packet a C2H stream queue delivers to the host.
  */
 class QdmaLogic : public Kernel {
    public:
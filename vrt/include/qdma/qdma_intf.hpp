@@ -27,8 +27,16 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "allocator/host_allocator.hpp"
+#include "qdma/qdma_queue_session.hpp"
+#include "utils/io_engine.hpp"
 #include "utils/logger.hpp"
 
 #define RW_MAX_SIZE 0x7ffff000  ///< Maximum size for read/write operations
@@ -40,35 +48,100 @@
 #define QDMA_QUEUE_NAME "qdma%s001"                              ///< Format for QDMA queue name
 #define QDMA_DEFAULT_QUEUE "/dev/qdma%s001-MM-0"                 ///< Default QDMA queue
 #define QDMA_DEFAULT_ST_QUEUE "/dev/qdma%s001-ST-%u"             ///< Default stream queue
+#define QDMA_MM_QUEUE "/dev/qdma%s001-MM-%u"                     ///< Additional MM queue
+#define QDMA_MM_QUEUE_BASE 16  ///< First index of the additional MM queues, above the ST qids
+#define QDMA_MM_QUEUE_COUNT 4  ///< Number of MM queues set up per device
+#define QDMA_DEFAULT_STRIPE_SIZE (4 << 20)  ///< Default stripe size of multi-queue transfers
+#define QDMA_ST_MAX_PACKET_SIZE 0xFFC0      ///< Largest packet length of the QDMA logic, in bytes
+#define QDMA_ST_PACKET_SIZE (32 << 10)      ///< Default packet length of C2H streams
+#define QDMA_ST_RING_SLOTS 4                ///< Host buffers in the ring of a C2H stream
+#define QDMA_ST_CANCEL_POLL_MS 50           ///< Cancellation check interval of packet reads
 
 namespace vrt {
+/**
+ * @brief Struct describing one contiguous piece of a batched transfer.
+ */
+struct QdmaSegment {
+    char* buffer;   ///< Host memory of the segment
+    uint64_t addr;  ///< Device address of the segment
+    uint64_t size;  ///< Size of the segment in bytes
+};
+
+/**
+ * @brief Struct holding the tunable parameters of the transfer engine.
+ */
+struct QdmaTransferConfig {
+    uint64_t chunkSize;    ///< Size of the chunks large transfers are cut into, in bytes
+    std::size_t depth;     ///< Number of chunks in flight
+    double bandwidth = 0;  ///< Measured bandwidth in bytes per second, 0 if not calibrated
+};
+
 /**
  * @brief Class for interfacing with QDMA.
  */
 class QdmaIntf {
-    uint8_t queueIdx;       ///< Queue index
-    std::string bdf;        ///< Bus:Device.Function identifier
-    std::string queueName;  ///< Queue name
+    /**
+     * @brief State shared by all copies of an interface.
+     */
+    struct SharedState {
+        std::vector<std::shared_ptr<QdmaQueueSession>> sessions;  ///< One session per queue
+        std::size_t activeQueues = 1;                     ///< Number of queues used for striping
+        uint64_t stripeSize = QDMA_DEFAULT_STRIPE_SIZE;   ///< Stripe size in bytes
+        std::size_t depth = 0;                            ///< Stripes in flight, 0 for per queue
+        std::shared_ptr<IoEngine> stripeEngine;           ///< Workers issuing the stripes
+        std::shared_ptr<HostAllocator> stagingAllocator;  ///< Memory of the staging buffers
+        std::mutex mutex;                                 ///< Guards the configuration
+    };
+
+    uint8_t queueIdx;                    ///< Queue index
+    std::string bdf;                     ///< Bus:Device.Function identifier
+    std::string queueName;               ///< Queue name
+    std::shared_ptr<SharedState> state;  ///< Queue sessions and striping configuration
+    bool streaming = false;              ///< Stream queue, transfers are issued unsplit
 
     /**
-     * @brief Writes data from a buffer to a device.
-     * @param dev The device to write to.
-     * @param buffer The buffer to write from.
-     * @param size The size of the buffer.
-     * @param base The base address to write to.
-     * @return The number of bytes written.
+     * @brief Transfers a buffer, striped across the active queues if it is large enough.
+     * @param write Flag indicating a host to device transfer.
+     * @param buffer The host buffer.
+     * @param start_addr The device address.
+     * @param size The size of the transfer in bytes.
      */
-    ssize_t write_from_buffer(const char* dev, char* buffer, uint64_t size, uint64_t base);
+    void transfer(bool write, char* buffer, uint64_t start_addr, uint64_t size);
 
     /**
-     * @brief Reads data from a file into a buffer.
-     * @param fname The file to read from.
-     * @param buffer The buffer to read into.
-     * @param size The size of the buffer.
-     * @param base The base address to read from.
-     * @return The number of bytes read.
+     * @brief Transfers a list of segments, spread across the active queues.
+     *
+     * Segments adjacent on the host and on the device are merged first. The result is cut into
+     * stripes, and the stripes are issued round robin on the active queues.
+     * The call returns once every stripe has completed.
+     *
+     * On a stream queue every write is one packet, so segments are issued as they are, in order
+     * and on the stream queue only.
+     *
+     * @param write Flag indicating a host to device transfer.
+     * @param segments The segments to transfer.
+     */
+    void transfer(bool write, const std::vector<QdmaSegment>& segments);
+
+    /**
+     * @brief Transfers an unaligned host buffer through page-aligned staging buffers.
+     *
+     * The host copy of one chunk overlaps with the DMA of the chunks in flight, which are spread
+     * round robin over the active queues up to the configured depth, so the copy costs little
+     * more than the DMA itself.
+     *
+     * @param write Flag indicating a host to device transfer.
+     * @param buffer The host buffer.
+     * @param start_addr The device address.
+     * @param size The size of the transfer in bytes.
      */
-    ssize_t read_to_buffer(const char* fname, char* buffer, uint64_t size, uint64_t base);
+    void transferStaged(bool write, char* buffer, uint64_t start_addr, uint64_t size);
+
+    /**
+     * @brief Makes sure the stripe engine has enough workers. Expects the state mutex held.
+     * @param workers The number of workers needed.
+     */
+    void reserveWorkers(std::size_t workers);
 
     /**
      * @brief Strips the bus part from the BDF.
@@ -119,6 +192,7 @@ class QdmaIntf {
      * @param buffer The buffer to write.
      * @param start_addr The starting address to write to.
      * @param size The size of the buffer.
+     * @throws std::runtime_error If the transfer fails.
      */
     void write_buff(char* buffer, uint64_t start_addr, uint64_t size);
 
@@ -127,14 +201,128 @@ class QdmaIntf {
      * @param buffer The buffer to read into.
      * @param start_addr The starting address to read from.
      * @param size The size of the buffer.
+     * @throws std::runtime_error If the transfer fails.
      */
     void read_buff(char* buffer, uint64_t start_addr, uint64_t size);
 
+    /**
+     * @brief Writes several host buffers to the device in one batch.
+     * @param segments The segments to write.
+     * @throws std::runtime_error If any transfer fails.
+     */
+    void write_batch(const std::vector<QdmaSegment>& segments);
+
+    /**
+     * @brief Reads several device ranges into host buffers in one batch.
+     * @param segments The segments to read.
+     * @throws std::runtime_error If any transfer fails.
+     */
+    void read_batch(const std::vector<QdmaSegment>& segments);
+
+    /**
+     * @brief Reads one packet from a C2H stream queue.
+     * @param buffer The buffer to read into.
+     * @param size The capacity of the buffer in bytes.
+     * @param cancel Flag that abandons the wait for the packet once set, may be null.
+     * @return The number of bytes received, smaller than size if the packet ended early, 0 if
+     * the read was cancelled.
+     * @throws std::runtime_error If the read fails.
+     */
+    uint64_t read_packet(char* buffer, uint64_t size,
+                         const std::atomic<bool>* cancel = nullptr);
+
     /**
      * @brief Gets the queue index.
      * @return The queue index.
      */
     uint32_t getQueueIdx();
+
+    /**
+     * @brief Closes the queue device descriptors held by this interface and its copies.
+     */
+    void close();
+
+    /**
+     * @brief Sets the number of MM queues large transfers are striped across.
+     *
+     * Only queues whose character device exists are used, so the count is clamped to the queues
+     * set up on the device.
+     *
+     * @param count The requested number of queues.
+     * @return The number of queues actually used.
+     */
+    std::size_t setQueueCount(std::size_t count);
+
+    /**
+     * @brief Gets the number of MM queues large transfers are striped across.
+     * @return The number of queues.
+     */
+    std::size_t getQueueCount();
+
+    /**
+     * @brief Sets the stripe size for multi-queue transfers.
+     * @param stripeSize The stripe size in bytes.
+     */
+    void setStripeSize(uint64_t stripeSize);
+
+    /**
+     * @brief Gets the stripe size for multi-queue transfers.
+     * @return The stripe size in bytes.
+     */
+    uint64_t getStripeSize();
+
+    /**
+     * @brief Sets the number of stripes in flight.
+     *
+     * Stripes are issued round robin on the active queues, so a depth above the queue count
+     * keeps several stripes in flight per queue.
+     *
+     * @param depth The number of stripes in flight, 0 for one per active queue.
+     */
+    void setInflightDepth(std::size_t depth);
+
+    /**
+     * @brief Gets the number of stripes in flight.
+     * @return The number of stripes in flight.
+     */
+    std::size_t getInflightDepth();
+
+    /**
+     * @brief Gets the current transfer engine configuration.
+     * @return The stripe size and the number of stripes in flight.
+     */
+    QdmaTransferConfig getTransferConfig();
+
+    /**
+     * @brief Applies a transfer engine configuration.
+     * @param config The configuration to apply.
+     */
+    void setTransferConfig(const QdmaTransferConfig& config);
+
+    /**
+     * @brief Measures the bandwidth of a range of chunk sizes and depths and applies the best.
+     *
+     * The scratch region is written and read back with every combination, its contents are
+     * overwritten.
+     *
+     * @param scratchAddr The device address of a scratch region.
+     * @param scratchSize The size of the scratch region in bytes.
+     * @return The best configuration with its measured bandwidth.
+     */
+    QdmaTransferConfig calibrate(uint64_t scratchAddr, uint64_t scratchSize);
+
+    /**
+     * @brief Sets the allocator providing the staging buffers of pipelined transfers.
+     * @param allocator The host allocator, usually the one of the device.
+     */
+    void setStagingAllocator(std::shared_ptr<HostAllocator> allocator);
+
+    /**
+     * @brief Gets the MM queue arguments for the queue setup script.
+     * @return The arguments adding all MM queues of a device.
+     */
+    static std::string getMmQueueSetupArgs();
+
     /**
      * @brief Destructor for QdmaIntf.
      */
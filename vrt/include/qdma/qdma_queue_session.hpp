@@ -0,0 +1,124 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef QDMA_QUEUE_SESSION_HPP
+#define QDMA_QUEUE_SESSION_HPP
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "utils/logger.hpp"
+
+namespace vrt {
+
+/**
+ * @brief Class owning the file descriptors of a QDMA queue character device.
+ *
+ * A session opens the queue device once per direction and keeps the descriptors open until it is
+ * closed or destroyed. Transfers use positional pread/pwrite, so a single session can be shared
+ * between threads without serializing on a file offset.
+ */
+class QdmaQueueSession {
+    std::string devicePath;  ///< Path of the queue character device
+    int h2cFd = -1;          ///< Descriptor used for host to card transfers
+    int c2hFd = -1;          ///< Descriptor used for card to host transfers
+    std::mutex fdMutex;      ///< Guards opening and closing of the descriptors
+
+    /**
+     * @brief Returns an open descriptor, opening the device on first use.
+     * @param fd The cached descriptor for the requested direction.
+     * @param flags The flags used to open the device.
+     * @return The open descriptor, or -1 on failure.
+     */
+    int acquireFd(int& fd, int flags);
+
+   public:
+    /**
+     * @brief Constructor for QdmaQueueSession.
+     * @param devicePath The path of the queue character device.
+     */
+    explicit QdmaQueueSession(const std::string& devicePath);
+
+    /**
+     * @brief Destructor for QdmaQueueSession. Closes any open descriptor.
+     */
+    ~QdmaQueueSession();
+
+    /**
+     * @brief Writes a host buffer to the queue.
+     * @param buffer The buffer to write from.
+     * @param size The number of bytes to write.
+     * @param offset The device address to write to.
+     * @return The number of bytes written, or -EIO on failure.
+     */
+    ssize_t write(const char* buffer, uint64_t size, uint64_t offset);
+
+    /**
+     * @brief Reads from the queue into a host buffer.
+     * @param buffer The buffer to read into.
+     * @param size The number of bytes to read.
+     * @param offset The device address to read from.
+     * @return The number of bytes read, or -EIO on failure.
+     */
+    ssize_t read(char* buffer, uint64_t size, uint64_t offset);
+
+    /**
+     * @brief Reads one packet from a stream queue.
+     *
+     * Unlike read(), a short read is not retried, since the packet may end before the buffer
+     * is full.
+     *
+     * With a cancel flag, the queue is polled for a packet and the flag checked in between, so
+     * the wait can be abandoned. A driver without poll support reports the queue readable right
+     * away; the read then blocks until a packet arrives or the driver's request times out.
+     *
+     * @param buffer The buffer to read into.
+     * @param size The capacity of the buffer in bytes.
+     * @param cancel Flag that abandons the wait once set, may be null.
+     * @return The number of bytes received, -ECANCELED if cancelled, or -EIO on failure.
+     */
+    ssize_t readPacket(char* buffer, uint64_t size, const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief Closes the descriptors. They are reopened on the next transfer.
+     */
+    void close();
+
+    /**
+     * @brief Gets the path of the queue character device.
+     * @return The device path.
+     */
+    const std::string& getDevicePath() const;
+
+    QdmaQueueSession(const QdmaQueueSession&) = delete;
+    QdmaQueueSession& operator=(const QdmaQueueSession&) = delete;
+};
+
+}  // namespace vrt
+
+#endif  // QDMA_QUEUE_SESSION_HPP
@@ -0,0 +1,75 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef ADAPTIVE_POLLER_HPP
+#define ADAPTIVE_POLLER_HPP
+
+#include <chrono>
+
+namespace vrt {
+
+/**
+ * @brief Class pacing a polling loop that waits for hardware.
+ *
+ * The poller spins first, so short waits return with the lowest latency. When the expected
+ * completion is still far away it sleeps for part of the remaining time. A wait that overruns
+ * its expectation first yields and then sleeps with a growing interval, so a waiting thread
+ * does not occupy a core.
+ */
+class AdaptivePoller {
+   public:
+    /// Time spent spinning before the poller starts yielding
+    static constexpr std::chrono::microseconds SPIN_TIME{20};
+    /// Time spent yielding before the poller starts sleeping
+    static constexpr std::chrono::microseconds YIELD_TIME{200};
+    /// Shortest sleep, below this the scheduler latency dominates
+    static constexpr std::chrono::microseconds MIN_SLEEP{20};
+    /// Longest sleep, bounds the latency added to a completion
+    static constexpr std::chrono::microseconds MAX_SLEEP{1000};
+
+    /**
+     * @brief Constructor for AdaptivePoller.
+     * @param expected Expected time until the condition becomes true, zero if unknown.
+     * @param timeout Time after which the wait is abandoned.
+     */
+    AdaptivePoller(std::chrono::nanoseconds expected, std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Waits before the next poll.
+     * @return False if the timeout has expired, true otherwise.
+     */
+    bool pause();
+
+    /**
+     * @brief Gets the time since the poller was created.
+     * @return The elapsed time.
+     */
+    std::chrono::nanoseconds elapsed() const;
+
+   private:
+    std::chrono::steady_clock::time_point start;  ///< Time the wait started
+    std::chrono::nanoseconds expected;            ///< Expected duration of the wait
+    std::chrono::nanoseconds timeout;             ///< Duration after which the wait is abandoned
+};
+
+}  // namespace vrt
+
+#endif  // ADAPTIVE_POLLER_HPP
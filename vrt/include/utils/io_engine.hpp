@@ -0,0 +1,89 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef IO_ENGINE_HPP
+#define IO_ENGINE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vrt {
+
+/**
+ * @brief Class implementing the runtime-owned I/O engine.
+ *
+ * The IoEngine is a fixed pool of worker threads that executes submitted transfers in FIFO
+ * order. It is shared by all copies of a Device and backs the asynchronous buffer API.
+ */
+class IoEngine {
+    std::vector<std::thread> workers;              ///< Worker threads
+    std::deque<std::packaged_task<void()>> tasks;  ///< Pending tasks
+    std::mutex mutex;                              ///< Guards the task queue
+    std::condition_variable condition;             ///< Signals new tasks and shutdown
+    bool stopping = false;                         ///< Set when the engine shuts down
+
+    /**
+     * @brief Main loop of a worker thread.
+     */
+    void workerLoop();
+
+   public:
+    /// Default number of worker threads
+    static constexpr std::size_t DEFAULT_WORKERS = 4;
+
+    /**
+     * @brief Constructor for IoEngine.
+     * @param numWorkers The number of worker threads.
+     */
+    explicit IoEngine(std::size_t numWorkers = DEFAULT_WORKERS);
+
+    /**
+     * @brief Destructor for IoEngine. Runs the remaining tasks and joins the workers.
+     */
+    ~IoEngine();
+
+    /**
+     * @brief Submits a task to the engine.
+     * @param task The task to execute.
+     * @return A future that becomes ready when the task has completed. Exceptions thrown by the
+     * task are rethrown when the future is read.
+     */
+    std::shared_future<void> submit(std::function<void()> task);
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of worker threads.
+     */
+    std::size_t getWorkerCount() const;
+
+    IoEngine(const IoEngine&) = delete;
+    IoEngine& operator=(const IoEngine&) = delete;
+};
+
+}  // namespace vrt
+
+#endif  // IO_ENGINE_HPP
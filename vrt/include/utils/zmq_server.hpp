@@ -24,6 +24,8 @@
 #include <json/json.h>
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <zmq.hpp>
 
@@ -31,18 +33,30 @@
 
 namespace vrt {
 
+/**
+ * @brief Struct describing a byte range of a named buffer on the server.
+ */
+struct ZmqBufferRange {
+    std::string name;  ///< Name identifier of the buffer
+    uint64_t offset;   ///< Byte offset inside the buffer
+    uint64_t size;     ///< Number of bytes
+};
+
 /**
  * @brief Class for managing ZeroMQ server communication.
  *
  * The ZmqServer class provides functionality for communication between the host application
  * and a simulation/emulation executable using the ZeroMQ messaging library. It supports sending and
  * receiving commands, buffers, and streams, as well as reading and writing scalar values.
+ * Requests are serialized internally, so a server can be shared between threads.
  */
 class ZmqServer {
    private:
     zmq::context_t context;  ///< ZeroMQ context for managing socket connections.
     zmq::socket_t socket;    ///< ZeroMQ socket for communication.
     std::string address = "tcp://localhost:5555";  ///< Default server address.
+    std::mutex socketMutex;  ///< Serializes request/reply exchanges on the socket.
+    bool closed = false;     ///< Set once the server was told to exit.
 
    public:
     /**
@@ -60,6 +74,38 @@ class ZmqServer {
      */
     void sendBuffer(const std::string& name, const std::vector<uint8_t>& buffer);
 
+    /**
+     * @brief Creates a zero-initialized named buffer on the server without sending contents.
+     *
+     * @param name The name identifier for the buffer.
+     * @param size The size of the buffer in bytes.
+     */
+    void allocateBuffer(const std::string& name, uint64_t size);
+
+    /**
+     * @brief Releases a named buffer on the server.
+     *
+     * Does nothing once the server was shut down, so buffers may outlive the device session.
+     *
+     * @param name The name identifier for the buffer.
+     */
+    void freeBuffer(const std::string& name);
+
+    /**
+     * @brief Tells the server to exit. Later buffer releases are skipped.
+     */
+    void shutdown();
+
+    /**
+     * @brief Writes a sub-range of a named buffer on the server.
+     *
+     * @param name The name identifier for the buffer.
+     * @param offset The byte offset inside the buffer.
+     * @param buffer The data to write at the offset.
+     */
+    void sendBufferRange(const std::string& name, uint64_t offset,
+                         const std::vector<uint8_t>& buffer);
+
     /**
      * @brief Sends a JSON command to the server.
      *
@@ -84,6 +130,34 @@ class ZmqServer {
      */
     std::vector<uint8_t> fetchBuffer(const std::string& name);
 
+    /**
+     * @brief Fetches a sub-range of a named buffer from the server.
+     *
+     * @param name The name identifier of the buffer to fetch.
+     * @param offset The byte offset inside the buffer.
+     * @param size The number of bytes to fetch.
+     * @return The requested buffer data.
+     */
+    std::vector<uint8_t> fetchBufferRange(const std::string& name, uint64_t offset,
+                                          uint64_t size);
+
+    /**
+     * @brief Writes several buffer ranges on the server in one request.
+     *
+     * @param ranges The ranges to write.
+     * @param data The data of all ranges, concatenated in the order of the ranges.
+     */
+    void sendBufferBatch(const std::vector<ZmqBufferRange>& ranges,
+                         const std::vector<uint8_t>& data);
+
+    /**
+     * @brief Fetches several buffer ranges from the server in one request.
+     *
+     * @param ranges The ranges to fetch.
+     * @return The data of all ranges, concatenated in the order of the ranges.
+     */
+    std::vector<uint8_t> fetchBufferBatch(const std::vector<ZmqBufferRange>& ranges);
+
     /**
      * @brief Sends a stream to the server.
      *
@@ -20,240 +20,652 @@
 
 #include "allocator/allocator.hpp"
 
-namespace vrt {
-Superblock::Superblock(uint64_t startAddress, uint64_t size)
-    : startAddress(startAddress), size(size), offset(0) {}
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-uint64_t Superblock::allocate(uint64_t size) {
-    if (!freeList.empty()) {
-        uint64_t addr = freeList.back();
-        freeList.pop_back();
-        return addr;
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "utils/logger.hpp"
+
+namespace vrt {
+Superblock::Superblock(uint64_t startAddress, uint64_t size, uint64_t blockSize)
+    : startAddress(startAddress),
+      size(size),
+      blockSize(blockSize),
+      blockCount(size / blockSize),
+      occupancy((blockCount + 63) / 64, 0),
+      cached(new std::atomic<uint64_t>[occupancy.size()]) {
+    // bits past the last block are kept set so they never look free
+    if (blockCount % 64 != 0) {
+        occupancy.back() = ~0ULL << (blockCount % 64);
     }
-    if (offset + size > this->size) {
+    for (std::size_t word = 0; word < occupancy.size(); word++) {
+        cached[word].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Superblock::allocate() {
+    if (isFull()) {
         throw std::bad_alloc();
     }
-    uint64_t addr = startAddress + offset;
-    offset += size;
-    return addr;
+    for (std::size_t word = searchHint; word < occupancy.size(); word++) {
+        if (occupancy[word] == ~0ULL) {
+            continue;
+        }
+        std::size_t bit = __builtin_ctzll(~occupancy[word]);
+        occupancy[word] |= 1ULL << bit;
+        usedCount++;
+        searchHint = word;
+        return startAddress + (word * 64 + bit) * blockSize;
+    }
+    throw std::bad_alloc();
+}
+
+void Superblock::deallocate(uint64_t addr) {
+    if (addr < startAddress || addr >= startAddress + size ||
+        (addr - startAddress) % blockSize != 0) {
+        throw std::invalid_argument("Address is not a block of this superblock");
+    }
+    std::size_t index = (addr - startAddress) / blockSize;
+    uint64_t mask = 1ULL << (index % 64);
+    if (!(occupancy[index / 64] & mask)) {
+        throw std::invalid_argument("Block is not allocated");
+    }
+    occupancy[index / 64] &= ~mask;
+    cached[index / 64].fetch_and(~mask, std::memory_order_relaxed);
+    usedCount--;
+    searchHint = std::min(searchHint, index / 64);
+}
+
+bool Superblock::isEmpty() const { return usedCount == 0; }
+
+bool Superblock::isAllocated(uint64_t addr) const {
+    if (addr < startAddress || addr >= startAddress + size ||
+        (addr - startAddress) % blockSize != 0) {
+        return false;
+    }
+    std::size_t index = (addr - startAddress) / blockSize;
+    return occupancy[index / 64] & (1ULL << (index % 64));
+}
+
+bool Superblock::markCached(uint64_t addr) {
+    std::size_t index = (addr - startAddress) / blockSize;
+    uint64_t mask = 1ULL << (index % 64);
+    return !(cached[index / 64].fetch_or(mask, std::memory_order_acq_rel) & mask);
+}
+
+void Superblock::clearCached(uint64_t addr) {
+    std::size_t index = (addr - startAddress) / blockSize;
+    cached[index / 64].fetch_and(~(1ULL << (index % 64)), std::memory_order_acq_rel);
+}
+
+bool Superblock::isFull() const { return usedCount == blockCount; }
+
+uint64_t Superblock::getBlockSize() const { return blockSize; }
+
+std::size_t Superblock::getUsedCount() const { return usedCount; }
+
+uint64_t AllocationPolicy::alignmentFor(uint64_t size) const {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Alignment must be a power of two");
+    }
+    // a block aligned to its size rounded up to a power of two cannot cross a larger boundary
+    uint64_t required = AXI_BEAT_SIZE;
+    while (required < size && required < alignment) {
+        required <<= 1;
+    }
+    return required;
 }
 
-void Superblock::deallocate(uint64_t addr) {}
+uint64_t AllocationPolicy::paddedSize(uint64_t size) const {
+    size = std::max<uint64_t>(size, 1);
+    return padToAxiBeat ? (size + AXI_BEAT_SIZE - 1) & ~(AXI_BEAT_SIZE - 1) : size;
+}
+
+MemoryRange::MemoryRange(MemoryRangeType type, uint64_t startAddress, uint64_t size,
+                         uint64_t granularity)
+    : type(type),
+      startAddress(startAddress),
+      size(size),
+      blocks(startAddress, size, granularity) {}
+
+namespace {
+/**
+ * @brief Thread-local registry of the caches of one thread, keyed by allocator id.
+ *
+ * Caches are marked orphaned when the thread exits, so the allocator can take their blocks
+ * back.
+ */
+struct LocalCaches {
+    std::unordered_map<uint64_t, std::shared_ptr<void>> caches;  ///< Caches by allocator id.
+    std::vector<std::atomic<bool>*> orphanFlags;                 ///< Orphan flags of the caches.
+    ~LocalCaches() {
+        for (auto* flag : orphanFlags) {
+            flag->store(true, std::memory_order_release);
+        }
+    }
+};
 
-MemoryRange::MemoryRange(uint64_t startAddress, uint64_t size)
-    : startAddress(startAddress), size(size), offset(0) {}
+thread_local LocalCaches localCaches;
+std::atomic<uint64_t> nextAllocatorId{0};
 
-Allocator::Allocator(uint64_t superblockSize) : superblockSize(superblockSize) {
+void atomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (current < value &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void copyCounters(const MemoryStatsBlock& from, MemoryStatsBlock& to) {
+    auto copy = [](const std::atomic<uint64_t>& a, std::atomic<uint64_t>& b) {
+        b.store(a.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    };
+    for (std::size_t i = 0; i < MEMORY_STATS_RANGES; i++) {
+        const MemoryRangeCounters& f = from.ranges[i];
+        MemoryRangeCounters& t = to.ranges[i];
+        copy(f.size, t.size);
+        copy(f.bytesInUse, t.bytesInUse);
+        copy(f.peakBytesInUse, t.peakBytesInUse);
+        copy(f.freeBytes, t.freeBytes);
+        copy(f.largestFreeBlock, t.largestFreeBlock);
+        copy(f.allocations, t.allocations);
+        copy(f.deallocations, t.deallocations);
+        copy(f.failedAllocations, t.failedAllocations);
+        copy(f.allocationNs, t.allocationNs);
+        copy(f.maxAllocationNs, t.maxAllocationNs);
+    }
+    for (std::size_t i = 0; i < MEMORY_STATS_PORTS; i++) {
+        copy(from.portBytesInUse[i], to.portBytesInUse[i]);
+        copy(from.portPeakBytes[i], to.portPeakBytes[i]);
+    }
+}
+
+void mergeCounters(const MemoryStatsBlock& before, const MemoryStatsBlock& after,
+                   MemoryStatsBlock& to) {
+    // sums take the difference, high-water marks the maximum; the free space counters are
+    // only written under the allocator lock and need no merge
+    auto add = [](const std::atomic<uint64_t>& b, const std::atomic<uint64_t>& a,
+                  std::atomic<uint64_t>& t) {
+        t.fetch_add(a.load(std::memory_order_relaxed) - b.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    };
+    auto max = [](const std::atomic<uint64_t>& a, std::atomic<uint64_t>& t) {
+        atomicMax(t, a.load(std::memory_order_relaxed));
+    };
+    for (std::size_t i = 0; i < MEMORY_STATS_RANGES; i++) {
+        const MemoryRangeCounters& b = before.ranges[i];
+        const MemoryRangeCounters& a = after.ranges[i];
+        MemoryRangeCounters& t = to.ranges[i];
+        add(b.bytesInUse, a.bytesInUse, t.bytesInUse);
+        add(b.allocations, a.allocations, t.allocations);
+        add(b.deallocations, a.deallocations, t.deallocations);
+        add(b.failedAllocations, a.failedAllocations, t.failedAllocations);
+        add(b.allocationNs, a.allocationNs, t.allocationNs);
+        max(a.peakBytesInUse, t.peakBytesInUse);
+        max(a.maxAllocationNs, t.maxAllocationNs);
+    }
+    for (std::size_t i = 0; i < MEMORY_STATS_PORTS; i++) {
+        add(before.portBytesInUse[i], after.portBytesInUse[i], to.portBytesInUse[i]);
+        max(after.portPeakBytes[i], to.portPeakBytes[i]);
+    }
+}
+
+MemoryRangeStats snapshot(const MemoryRangeCounters& counters) {
+    MemoryRangeStats stats;
+    stats.size = counters.size.load(std::memory_order_relaxed);
+    stats.bytesInUse = counters.bytesInUse.load(std::memory_order_relaxed);
+    stats.peakBytesInUse = counters.peakBytesInUse.load(std::memory_order_relaxed);
+    stats.freeBytes = counters.freeBytes.load(std::memory_order_relaxed);
+    stats.largestFreeBlock = counters.largestFreeBlock.load(std::memory_order_relaxed);
+    stats.fragmentation =
+        stats.freeBytes == 0 ? 0.0
+                             : 1.0 - static_cast<double>(stats.largestFreeBlock) / stats.freeBytes;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.deallocations = counters.deallocations.load(std::memory_order_relaxed);
+    stats.failedAllocations = counters.failedAllocations.load(std::memory_order_relaxed);
+    uint64_t allocationNs = counters.allocationNs.load(std::memory_order_relaxed);
+    stats.averageAllocationNs =
+        stats.allocations == 0 ? 0.0 : static_cast<double>(allocationNs) / stats.allocations;
+    stats.maxAllocationNs = counters.maxAllocationNs.load(std::memory_order_relaxed);
+    return stats;
+}
+}  // namespace
+
+Allocator::StatsGuard::StatsGuard(const Allocator& allocator)
+    : allocator(allocator), epoch(allocator.statsEpoch.load()) {
+    // counted before the pointer is loaded, so a switch either is seen or waits for the guard
+    allocator.statsUsers[epoch].fetch_add(1);
+    block = allocator.stats.load();
+}
+
+Allocator::StatsGuard::~StatsGuard() { allocator.statsUsers[epoch].fetch_sub(1); }
+
+MemoryStatsBlock* Allocator::StatsGuard::operator->() const { return block; }
+
+Allocator::Allocator(uint64_t superblockSize)
+    : superblockSize(superblockSize),
+      id(nextAllocatorId.fetch_add(1)),
+      localStats(std::make_unique<MemoryStatsBlock>()),
+      stats(localStats.get()) {
+    if (superblockSize < 2 * SLAB_MIN_BLOCK_SIZE || (superblockSize & (superblockSize - 1))) {
+        throw std::invalid_argument("Superblock size must be a power of two of at least " +
+                                    std::to_string(2 * SLAB_MIN_BLOCK_SIZE) + " bytes");
+    }
     addMemoryRange(MemoryRangeType::HBM, HBM_START, HBM_SIZE);
     addMemoryRange(MemoryRangeType::DDR, DDR_START, DDR_SIZE);
 }
 
+Allocator::~Allocator() { unshareStats(); }
+
 void Allocator::addMemoryRange(MemoryRangeType type, uint64_t startAddress, uint64_t size) {
-    memoryRanges.emplace(type, MemoryRange(startAddress, size));
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    // large blocks start on a page and superblocks on their size, so free blocks of the
+    // smaller granule keep allocations with the default alignment at O(log n)
+    uint64_t granularity = std::min(LARGE_BLOCK_ALIGNMENT, superblockSize);
+    auto it = memoryRanges.emplace(type, MemoryRange(type, startAddress, size, granularity)).first;
+    stats.load()->ranges[static_cast<std::size_t>(type)].size.store(it->second.size);
+    updateFreeStats(it->second);
 }
 
-uint64_t Allocator::allocate(uint64_t size, MemoryRangeType type) {
-    if (type == MemoryRangeType::HBM) {
-        return allocate(size, type, 0);
-    }
-    auto it = memoryRanges.find(type);
-    if (it == memoryRanges.end()) {
-        throw std::out_of_range("Invalid memory range type");
+std::size_t Allocator::sizeClassOf(uint64_t size) {
+    std::size_t sizeClass = 0;
+    while ((SLAB_MIN_BLOCK_SIZE << sizeClass) < size) {
+        sizeClass++;
     }
+    return sizeClass;
+}
 
-    MemoryRange& range = it->second;
+uint32_t Allocator::cacheKey(MemoryRangeType type, std::size_t sizeClass) {
+    return (static_cast<uint32_t>(type) << 8) | static_cast<uint32_t>(sizeClass);
+}
 
-    if (size < superblockSize / 2) {
-        for (auto& superblock : range.superblocks) {
-            try {
-                uint64_t addr = superblock.allocate(size);
-                addrToSuperblock[addr] = &superblock;
-                return addr;
-            } catch (const std::bad_alloc&) {
-                continue;
-            }
-        }
-        if (range.offset + superblockSize > range.size) {
-            throw std::bad_alloc();
-        }
-        range.superblocks.emplace_back(range.startAddress + range.offset, superblockSize);
-        range.offset += superblockSize;
-        uint64_t addr = range.superblocks.back().allocate(size);
-        addrToSuperblock[addr] = &range.superblocks.back();
-        return addr;
-    } else {
-        if (!range.freeList.empty()) {
-            uint64_t addr = range.freeList.back();
-            range.freeList.pop_back();
-            return addr;
-        }
-        if (range.offset + size > range.size) {
-            throw std::bad_alloc();
+Allocator::ThreadCache& Allocator::getThreadCache() {
+    auto it = localCaches.caches.find(id);
+    if (it != localCaches.caches.end()) {
+        return *static_cast<ThreadCache*>(it->second.get());
+    }
+    auto cache = std::make_shared<ThreadCache>();
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        threadCaches.push_back(cache);
+    }
+    localCaches.orphanFlags.push_back(&cache->orphaned);
+    localCaches.caches.emplace(id, cache);
+    return *cache;
+}
+
+void Allocator::drainOrphanedCaches() {
+    for (auto it = threadCaches.begin(); it != threadCaches.end();) {
+        if (!(*it)->orphaned.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
         }
-        uint64_t addr = range.startAddress;
-        while (addr + size <= range.startAddress + range.size) {
-            bool isOccupied = std::any_of(
-                range.usedMemoryBlocks.begin(), range.usedMemoryBlocks.end(),
-                [addr, size](const std::pair<uint64_t, uint64_t>& block) {
-                    return (addr >= block.first && addr < block.first + block.second) ||
-                           (addr + size > block.first && addr + size <= block.first + block.second);
-                });
-
-            if (!isOccupied) {
-                range.usedMemoryBlocks.push_back({addr, size});
-                return addr;
+        for (auto& [key, blocks] : (*it)->freeBlocks) {
+            for (const CachedBlock& block : blocks) {
+                deallocateSmall(superblockIndex.at(block.addr & ~(superblockSize - 1)),
+                                block.addr);
             }
+        }
+        it = threadCaches.erase(it);
+    }
+}
 
-            addr += size;
+uint64_t Allocator::allocateSmall(MemoryRange& range, uint64_t size, uint64_t minAddress,
+                                  uint64_t maxAddress) {
+    std::size_t sizeClass = sizeClassOf(size);
+    if (range.sizeClasses.size() <= sizeClass) {
+        range.sizeClasses.resize(sizeClass + 1);
+    }
+    auto& superblocks = range.sizeClasses[sizeClass];
+
+    // superblocks with free blocks are at the front, full ones at the back
+    auto it = superblocks.begin();
+    for (; it != superblocks.end() && !it->isFull(); ++it) {
+        if (it->startAddress >= minAddress && it->startAddress < maxAddress) {
+            break;
         }
+    }
+    if (it == superblocks.end() || it->isFull()) {
+        bool wholeRange =
+            minAddress == range.startAddress && maxAddress == range.startAddress + range.size;
+        uint64_t superblockAddr = wholeRange
+                                      ? range.blocks.allocate(superblockSize, superblockSize)
+                                      : range.blocks.allocateFrom(superblockSize, superblockSize,
+                                                                  minAddress);
+        it = superblocks.emplace(superblocks.begin(), superblockAddr, superblockSize,
+                                 SLAB_MIN_BLOCK_SIZE << sizeClass);
+        superblockIndex[superblockAddr] = SuperblockRef{&range, sizeClass, it};
+        updateFreeStats(range);
+    }
 
-        throw std::bad_alloc();
+    uint64_t addr = it->allocate();
+    if (it->isFull()) {
+        superblocks.splice(superblocks.end(), superblocks, it);
     }
+    return addr;
 }
 
-void Allocator::deallocate(uint64_t addr) {
-    auto it = addrToSuperblock.find(addr);
-    if (it != addrToSuperblock.end()) {
-        it->second->deallocate(addr);
-        addrToSuperblock.erase(it);
-    } else {
-        for (auto& [type, range] : memoryRanges) {
-            if (addr >= range.startAddress && addr < range.startAddress + range.size) {
-                range.freeList.push_back(addr);
-                return;
-            }
-        }
+void Allocator::deallocateSmall(const SuperblockRef& ref, uint64_t addr) {
+    auto& superblocks = ref.range->sizeClasses[ref.sizeClass];
+    auto superblock = ref.superblock;
+    bool wasFull = superblock->isFull();
+    superblock->deallocate(addr);
+    if (superblock->isEmpty() && superblocks.size() > 1) {
+        // empty superblocks go back to the range, one per class is kept against churn
+        uint64_t superblockAddr = superblock->startAddress;
+        MemoryRange* range = ref.range;
+        superblockIndex.erase(superblockAddr);  // invalidates ref
+        superblocks.erase(superblock);
+        range->blocks.deallocate(superblockAddr);
+        updateFreeStats(*range);
+    } else if (wasFull) {
+        superblocks.splice(superblocks.begin(), superblocks, superblock);
     }
 }
 
+uint64_t Allocator::allocate(uint64_t size, MemoryRangeType type) {
+    return allocateTracked(size, type, -1, defaultPolicy);
+}
+
+uint64_t Allocator::allocate(uint64_t size, MemoryRangeType type, const AllocationPolicy& policy) {
+    return allocateTracked(size, type, -1, policy);
+}
+
 uint64_t Allocator::allocate(uint64_t size, MemoryRangeType type, uint8_t port) {
-    auto it = memoryRanges.find(type);
-    if (it == memoryRanges.end()) {
-        throw std::out_of_range("Invalid memory range type");
-    }
+    return allocate(size, type, port, defaultPolicy);
+}
 
+uint64_t Allocator::allocate(uint64_t size, MemoryRangeType type, uint8_t port,
+                             const AllocationPolicy& policy) {
     if (port > 31) {
         throw std::out_of_range("Invalid port number");
     }
+    return allocateTracked(size, type, type == MemoryRangeType::HBM ? port : -1, policy);
+}
+
+void Allocator::setDefaultPolicy(const AllocationPolicy& policy) {
+    policy.alignmentFor(0);  // validates the alignment
+    defaultPolicy = policy;
+}
+
+const AllocationPolicy& Allocator::getDefaultPolicy() const { return defaultPolicy; }
+
+uint64_t Allocator::allocateTracked(uint64_t size, MemoryRangeType type, int port,
+                                    const AllocationPolicy& policy) {
+    size = policy.paddedSize(size);
+    uint64_t alignment = std::max(LARGE_BLOCK_ALIGNMENT, policy.alignmentFor(size));
+    auto start = std::chrono::steady_clock::now();
+    uint64_t blockSize = 0;
+    uint64_t addr;
+    // counters are pinned only outside the lock, which switching them holds while it waits
+    try {
+        addr = allocateBlock(size, type, port, alignment, blockSize);
+    } catch (const std::bad_alloc&) {
+        StatsGuard pinned(*this);
+        MemoryRangeCounters& counters = pinned->ranges[static_cast<std::size_t>(type)];
+        counters.failedAllocations.fetch_add(1, std::memory_order_relaxed);
+        utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                           "Out of device memory: requested {} bytes, {} bytes in use, {} bytes "
+                           "free, largest free block {} bytes",
+                           size, counters.bytesInUse.load(), counters.freeBytes.load(),
+                           counters.largestFreeBlock.load());
+        throw;
+    }
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    StatsGuard pinned(*this);
+    MemoryRangeCounters& counters = pinned->ranges[static_cast<std::size_t>(type)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.allocationNs.fetch_add(ns, std::memory_order_relaxed);
+    atomicMax(counters.maxAllocationNs, ns);
+    accountBlock(type, addr, blockSize, true);
+    return addr;
+}
 
-    if (type != MemoryRangeType::HBM) {
-        return allocate(size, type);
+uint64_t Allocator::allocateBlock(uint64_t size, MemoryRangeType type, int port,
+                                  uint64_t alignment, uint64_t& blockSize) {
+    // size classes are naturally aligned, so small blocks meet any policy
+    if (size < superblockSize / 2 && port < 0) {
+        std::size_t sizeClass = sizeClassOf(size);
+        blockSize = SLAB_MIN_BLOCK_SIZE << sizeClass;
+        auto& blocks = getThreadCache().freeBlocks[cacheKey(type, sizeClass)];
+        if (blocks.empty()) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto it = memoryRanges.find(type);
+            if (it == memoryRanges.end()) {
+                throw std::out_of_range("Invalid memory range type");
+            }
+            drainOrphanedCaches();
+            MemoryRange& range = it->second;
+            uint64_t rangeEnd = range.startAddress + range.size;
+            auto refill = [&]() {
+                uint64_t addr = allocateSmall(range, size, range.startAddress, rangeEnd);
+                Superblock& superblock =
+                    *superblockIndex.at(addr & ~(superblockSize - 1)).superblock;
+                superblock.markCached(addr);
+                blocks.push_back(CachedBlock{addr, &superblock});
+            };
+            refill();
+            for (std::size_t i = 1; i < THREAD_CACHE_REFILL; i++) {
+                try {
+                    refill();
+                } catch (const std::bad_alloc&) {
+                    break;
+                }
+            }
+            // hand out the lowest address first
+            std::sort(blocks.begin(), blocks.end(),
+                      [](const CachedBlock& a, const CachedBlock& b) { return a.addr > b.addr; });
+        }
+        CachedBlock block = blocks.back();
+        blocks.pop_back();
+        block.superblock->clearCached(block.addr);
+        return block.addr;
     }
 
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = memoryRanges.find(type);
+    if (it == memoryRanges.end()) {
+        throw std::out_of_range("Invalid memory range type");
+    }
     MemoryRange& range = it->second;
-    uint64_t portBaseAddress = HBM_START + port * HBM_PORT_SIZE;
-    uint64_t portEndAddress =
-        portBaseAddress + 2 * HBM_PORT_SIZE * 8;  // allow moving to next port (aligned at 64bit)
 
+    if (port < 0) {
+        uint64_t addr = range.blocks.allocate(size, alignment);
+        blockSize = range.blocks.getBlockSize(addr);
+        updateFreeStats(range);
+        return addr;
+    }
+
+    // blocks start at the lowest free address of the port and may run into the next ports
+    uint64_t portBaseAddress = range.startAddress + port * HBM_PORT_SIZE;
     if (size < superblockSize / 2) {
-        for (auto& superblock : range.superblocks) {
-            if (superblock.startAddress < portBaseAddress ||
-                superblock.startAddress >= portBaseAddress + HBM_PORT_SIZE) {
-                continue;
-            }
-            try {
-                uint64_t addr = superblock.allocate(size);
-                addrToSuperblock[addr] = &superblock;
-                return addr;
-            } catch (const std::bad_alloc&) {
-                continue;
+        blockSize = SLAB_MIN_BLOCK_SIZE << sizeClassOf(size);
+        return allocateSmall(range, size, portBaseAddress, portBaseAddress + HBM_PORT_SIZE);
+    }
+    uint64_t addr = range.blocks.allocateFrom(size, alignment, portBaseAddress);
+    blockSize = range.blocks.getBlockSize(addr);
+    updateFreeStats(range);
+    return addr;
+}
+
+void Allocator::deallocate(uint64_t addr) {
+    uint32_t key = 0;
+    MemoryRangeType type = MemoryRangeType::HBM;
+    std::size_t sizeClass = 0;
+    Superblock* superblock = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = superblockIndex.find(addr & ~(superblockSize - 1));
+        if (it != superblockIndex.end()) {
+            // cached blocks stay allocated in their superblock, so it cannot go away
+            superblock = &*it->second.superblock;
+            if (!superblock->isAllocated(addr) || !superblock->markCached(addr)) {
+                throw std::invalid_argument("Block is not allocated");
             }
+            type = it->second.range->type;
+            sizeClass = it->second.sizeClass;
+            key = cacheKey(type, sizeClass) + 1;
         }
-        if (range.offset + superblockSize > range.size) {
-            throw std::bad_alloc();
-        }
-        uint64_t sbs = superblockSize;
-        // Check if the range is already occupied in usedMemoryBlocks
-        bool isOccupied =
-            std::any_of(range.usedMemoryBlocks.begin(), range.usedMemoryBlocks.end(),
-                        [portBaseAddress, sbs](const std::pair<uint64_t, uint64_t>& block) {
-                            return (portBaseAddress >= block.first &&
-                                    portBaseAddress < block.first + block.second) ||
-                                   (portBaseAddress + sbs > block.first &&
-                                    portBaseAddress + sbs <= block.first + block.second);
-                        });
-
-        if (!isOccupied) {
-            // Allocate a new superblock from portBaseAddress
-            range.superblocks.emplace_back(portBaseAddress, superblockSize);
-            uint64_t addr = range.superblocks.back().allocate(size);
-            addrToSuperblock[addr] = &range.superblocks.back();
-            range.usedMemoryBlocks.push_back({addr, superblockSize});
-            return addr;
-        } else {
-            // Find the next free block
-            uint64_t nextFreeAddress = portBaseAddress;
-            for (const auto& block : range.usedMemoryBlocks) {
-                if (nextFreeAddress >= block.first &&
-                    nextFreeAddress < block.first + block.second) {
-                    nextFreeAddress = block.first + block.second;
-                }
-            }
+    }
 
-            // Check if the next free block is within the range
-            if (nextFreeAddress + superblockSize <= range.startAddress + range.size) {
-                range.superblocks.emplace_back(nextFreeAddress, superblockSize);
-                uint64_t addr = range.superblocks.back().allocate(size);
-                addrToSuperblock[addr] = &range.superblocks.back();
-                range.usedMemoryBlocks.push_back({addr, size});
-                return addr;
-            } else {
-                throw std::bad_alloc();
+    if (key != 0) {
+        accountBlock(type, addr, SLAB_MIN_BLOCK_SIZE << sizeClass, false);
+        auto& blocks = getThreadCache().freeBlocks[key - 1];
+        blocks.push_back(CachedBlock{addr, superblock});
+        if (blocks.size() > THREAD_CACHE_BLOCKS) {
+            // the oldest blocks go back to their superblocks
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto keep = blocks.end() - THREAD_CACHE_BLOCKS / 2;
+            for (auto block = blocks.begin(); block != keep; ++block) {
+                deallocateSmall(superblockIndex.at(block->addr & ~(superblockSize - 1)),
+                                block->addr);
             }
+            blocks.erase(blocks.begin(), keep);
         }
+        return;
+    }
 
-    } else {
-        if (!range.freeList.empty()) {
-            auto it =
-                std::find_if(range.freeList.begin(), range.freeList.end(),
-                             [portBaseAddress](uint64_t addr) { return addr > portBaseAddress; });
-
-            if (it != range.freeList.end()) {
-                uint64_t foundAddress = *it;
-                range.freeList.erase(it);  // Remove the allocated address from the free list
-                return foundAddress;
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (auto& [rangeType, range] : memoryRanges) {
+        if (range.blocks.contains(addr)) {
+            uint64_t blockSize = range.blocks.getBlockSize(addr);
+            if (range.blocks.deallocate(addr)) {
+                accountBlock(rangeType, addr, blockSize, false);
+                updateFreeStats(range);
             }
+            return;
         }
-        // Search in usedMemoryBlocks for the next free address within the port range
-        uint64_t nextFreeAddress = portBaseAddress;
-        for (const auto& block : range.usedMemoryBlocks) {
-            if (block.first + block.second >= portBaseAddress &&
-                block.first + block.second < portEndAddress) {
-                nextFreeAddress = block.first + block.second;
-            }
+    }
+}
+
+void Allocator::flushThreadCache() {
+    ThreadCache& cache = getThreadCache();
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (auto& [key, blocks] : cache.freeBlocks) {
+        for (const CachedBlock& block : blocks) {
+            deallocateSmall(superblockIndex.at(block.addr & ~(superblockSize - 1)), block.addr);
         }
+        blocks.clear();
+    }
+}
 
-        // Check if the next free block is within the port range
-        if (nextFreeAddress + size <= portEndAddress) {
-            range.usedMemoryBlocks.push_back(
-                {nextFreeAddress, size});  // Keep track of the used block
-            return nextFreeAddress;
+void Allocator::accountBlock(MemoryRangeType type, uint64_t addr, uint64_t bytes, bool add) {
+    StatsGuard pinned(*this);
+    MemoryRangeCounters& counters = pinned->ranges[static_cast<std::size_t>(type)];
+    if (add) {
+        uint64_t inUse = counters.bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        atomicMax(counters.peakBytesInUse, inUse);
+    } else {
+        counters.bytesInUse.fetch_sub(bytes, std::memory_order_relaxed);
+        counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (type != MemoryRangeType::HBM || addr < HBM_START) {
+        return;
+    }
+    // large blocks may span several ports, each port is charged its share
+    uint64_t end = addr + bytes;
+    for (uint64_t port = (addr - HBM_START) / HBM_PORT_SIZE;
+         port < MEMORY_STATS_PORTS && HBM_START + port * HBM_PORT_SIZE < end; port++) {
+        uint64_t portStart = HBM_START + port * HBM_PORT_SIZE;
+        uint64_t share =
+            std::min(end, portStart + HBM_PORT_SIZE) - std::max(addr, portStart);
+        if (add) {
+            uint64_t inUse =
+                pinned->portBytesInUse[port].fetch_add(share, std::memory_order_relaxed) + share;
+            atomicMax(pinned->portPeakBytes[port], inUse);
+        } else {
+            pinned->portBytesInUse[port].fetch_sub(share, std::memory_order_relaxed);
         }
+    }
+}
 
-        // Allocate from portBaseAddress
-        uint64_t addr = portBaseAddress;
-        while (addr + size <= range.startAddress + range.size) {
-            // Check if the address range is occupied
-            bool isOccupied = std::any_of(
-                range.usedMemoryBlocks.begin(), range.usedMemoryBlocks.end(),
-                [addr, size](const std::pair<uint64_t, uint64_t>& block) {
-                    return (addr >= block.first && addr < block.first + block.second) ||
-                           (addr + size > block.first && addr + size <= block.first + block.second);
-                });
-
-            if (!isOccupied) {
-                range.usedMemoryBlocks.push_back({addr, size});  // Keep track of the used block
-                return addr;
-            }
+void Allocator::updateFreeStats(const MemoryRange& range) {
+    MemoryRangeCounters& counters = stats.load()->ranges[static_cast<std::size_t>(range.type)];
+    counters.freeBytes.store(range.blocks.getFreeBytes(), std::memory_order_relaxed);
+    counters.largestFreeBlock.store(range.blocks.getLargestFreeBlock(),
+                                    std::memory_order_relaxed);
+}
 
-            addr += size;  // Move to the next block
-        }
+MemoryStats Allocator::getStats() const {
+    StatsGuard pinned(*this);
+    MemoryStats result;
+    result.hbm = snapshot(pinned->ranges[static_cast<std::size_t>(MemoryRangeType::HBM)]);
+    result.ddr = snapshot(pinned->ranges[static_cast<std::size_t>(MemoryRangeType::DDR)]);
+    for (std::size_t i = 0; i < MEMORY_STATS_PORTS; i++) {
+        result.portBytesInUse[i] = pinned->portBytesInUse[i].load(std::memory_order_relaxed);
+        result.portPeakBytes[i] = pinned->portPeakBytes[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
 
-        throw std::bad_alloc();
+void Allocator::shareStats(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!sharedStatsName.empty()) {
+        return;
+    }
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create shared memory segment " + name + ": " +
+                                 std::strerror(errno));
+    }
+    fchmod(fd, 0666);  // readable by v80-smi of other users despite the umask
+    if (ftruncate(fd, sizeof(MemoryStatsBlock)) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to size shared memory segment " + name);
+    }
+    void* mapping =
+        mmap(nullptr, sizeof(MemoryStatsBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory segment " + name);
+    }
+    auto* shared = static_cast<MemoryStatsBlock*>(mapping);
+    reinterpret_cast<std::atomic<uint32_t>*>(&shared->magic)->store(0);
+    switchStats(shared);
+    shared->version = MEMORY_STATS_VERSION;
+    shared->pid = getpid();
+    reinterpret_cast<std::atomic<uint32_t>*>(&shared->magic)
+        ->store(MEMORY_STATS_MAGIC, std::memory_order_release);
+    sharedStatsName = name;
+}
+
+void Allocator::unshareStats() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (sharedStatsName.empty()) {
+        return;
+    }
+    MemoryStatsBlock* shared = switchStats(localStats.get());
+    munmap(shared, sizeof(MemoryStatsBlock));
+    shm_unlink(sharedStatsName.c_str());
+    sharedStatsName.clear();
+}
+
+MemoryStatsBlock* Allocator::switchStats(MemoryStatsBlock* next) {
+    MemoryStatsBlock* previous = stats.load();
+    auto before = std::make_unique<MemoryStatsBlock>();
+    copyCounters(*previous, *before);
+    copyCounters(*before, *next);
+    stats.store(next);
+    // new guards are counted in the other epoch, so only guards that may hold the previous
+    // block are waited for
+    uint32_t epoch = statsEpoch.load();
+    statsEpoch.store(epoch ^ 1);
+    while (statsUsers[epoch].load() != 0) {
+        std::this_thread::yield();
     }
+    mergeCounters(*before, *previous, *next);
+    return previous;
 }
 
 uint64_t Allocator::getSize(MemoryRangeType type) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
     auto it = memoryRanges.find(type);
     if (it == memoryRanges.end()) {
         throw std::out_of_range("Invalid memory range type");
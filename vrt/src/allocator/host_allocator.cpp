@@ -0,0 +1,180 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "allocator/host_allocator.hpp"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "utils/logger.hpp"
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+namespace vrt {
+
+HostAllocator::HostAllocator(int numaNode) : numaNode(numaNode) {}
+
+HostAllocator::~HostAllocator() { trim(); }
+
+void* HostAllocator::allocate(std::size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t pageSize = hugePages ? HOST_HUGE_PAGE_SIZE : HOST_PAGE_SIZE;
+    std::size_t mappedSize = ((size > 0 ? size : 1) + pageSize - 1) / pageSize * pageSize;
+
+    // reuse a pooled block unless it would waste more than half of it
+    auto it = pool.lower_bound(mappedSize);
+    if (it != pool.end() && it->first <= 2 * mappedSize) {
+        void* ptr = it->second;
+        pooledBytes -= it->first;
+        blocks[ptr] = it->first;
+        pool.erase(it);
+        return ptr;
+    }
+
+    void* ptr = mapBlock(mappedSize);
+    bindBlock(ptr, mappedSize);
+    if (lockPages && mlock(ptr, mappedSize) != 0) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Could not lock {} bytes of host memory", mappedSize);
+    }
+    blocks[ptr] = mappedSize;
+    return ptr;
+}
+
+void HostAllocator::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = blocks.find(ptr);
+    if (it == blocks.end()) {
+        throw std::invalid_argument("Pointer not allocated by this host allocator");
+    }
+    std::size_t mappedSize = it->second;
+    blocks.erase(it);
+    if (pooledBytes + mappedSize <= poolLimit) {
+        pool.emplace(mappedSize, ptr);
+        pooledBytes += mappedSize;
+    } else {
+        munmap(ptr, mappedSize);
+    }
+}
+
+void* HostAllocator::mapBlock(std::size_t size) {
+    int prot = PROT_READ | PROT_WRITE;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (!hugePages) {
+        void* ptr = mmap(nullptr, size, prot, flags, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void* ptr = mmap(nullptr, size, prot, flags | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+    if (ptr != MAP_FAILED) {
+        return ptr;
+    }
+    // no reserved huge pages, align the mapping so transparent huge pages can back it
+    std::size_t padded = size + HOST_HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, prot, flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uintptr_t rawAddr = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t alignedAddr = (rawAddr + HOST_HUGE_PAGE_SIZE - 1) & ~(HOST_HUGE_PAGE_SIZE - 1);
+    if (alignedAddr > rawAddr) {
+        munmap(raw, alignedAddr - rawAddr);
+    }
+    std::size_t tail = rawAddr + padded - (alignedAddr + size);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(alignedAddr + size), tail);
+    }
+    madvise(reinterpret_cast<void*>(alignedAddr), size, MADV_HUGEPAGE);
+    return reinterpret_cast<void*>(alignedAddr);
+}
+
+void HostAllocator::bindBlock(void* ptr, std::size_t size) {
+    if (numaNode < 0) {
+        return;
+    }
+    constexpr std::size_t bitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> nodeMask(numaNode / bitsPerWord + 1, 0);
+    nodeMask[numaNode / bitsPerWord] |= 1UL << (numaNode % bitsPerWord);
+    // preferred rather than strict binding, so a full node falls back instead of failing
+    if (syscall(SYS_mbind, ptr, size, MPOL_PREFERRED, nodeMask.data(),
+                nodeMask.size() * bitsPerWord, 0) != 0) {
+        utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                           "Could not bind host memory to NUMA node {}", numaNode);
+    }
+}
+
+void HostAllocator::setNumaNode(int numaNode) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (this->numaNode != numaNode) {
+        releasePool();
+        this->numaNode = numaNode;
+    }
+}
+
+int HostAllocator::getNumaNode() const { return numaNode; }
+
+void HostAllocator::setHugePages(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (hugePages != enable) {
+        releasePool();
+        hugePages = enable;
+    }
+}
+
+void HostAllocator::setLockPages(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (lockPages != enable) {
+        releasePool();
+        lockPages = enable;
+    }
+}
+
+void HostAllocator::setPoolLimit(std::size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    poolLimit = limit;
+}
+
+void HostAllocator::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    releasePool();
+}
+
+void HostAllocator::releasePool() {
+    for (auto& [mappedSize, ptr] : pool) {
+        munmap(ptr, mappedSize);
+    }
+    pool.clear();
+    pooledBytes = 0;
+}
+
+}  // namespace vrt
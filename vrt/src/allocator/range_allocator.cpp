@@ -0,0 +1,253 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "allocator/range_allocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace vrt {
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+RangeAllocator::RangeAllocator(uint64_t startAddress, uint64_t size, uint64_t granularity)
+    : startAddress(startAddress), size(size), granularity(granularity), freeBytes(0) {
+    if (granularity == 0 || (granularity & (granularity - 1)) != 0 ||
+        startAddress % granularity != 0 || size % granularity != 0) {
+        throw std::invalid_argument("Invalid range granularity");
+    }
+    if (size > 0) {
+        insertFree(startAddress, size);
+    }
+}
+
+uint64_t RangeAllocator::allocate(uint64_t size, uint64_t alignment) {
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Invalid allocation size or alignment");
+    }
+    size = alignUp(size, granularity);
+    alignment = std::max(alignment, granularity);
+    // free blocks start on a granule, so from size + alignment - granularity on every block
+    // fits; smaller ones only fit if their start happens to be aligned
+    uint64_t alwaysFits = size + alignment - granularity;
+    auto it = freeBySize.lower_bound({size, 0});
+    while (it != freeBySize.end() && it->first < alwaysFits) {
+        uint64_t addr = alignUp(it->second, alignment);
+        if (addr + size <= it->second + it->first) {
+            return carve(freeByAddress.find(it->second), addr, size);
+        }
+        ++it;
+    }
+    if (it == freeBySize.end()) {
+        throw std::bad_alloc();
+    }
+    return carve(freeByAddress.find(it->second), alignUp(it->second, alignment), size);
+}
+
+uint64_t RangeAllocator::allocateFrom(uint64_t size, uint64_t alignment, uint64_t minAddress) {
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Invalid allocation size or alignment");
+    }
+    size = alignUp(size, granularity);
+    alignment = std::max(alignment, granularity);
+    // only the part above minAddress of a block holding it can be used
+    auto holding = freeByAddress.upper_bound(minAddress);
+    if (holding != freeByAddress.begin()) {
+        --holding;
+        uint64_t addr = alignUp(minAddress, alignment);
+        if (holding->first < minAddress && addr + size <= holding->first + holding->second) {
+            return carve(holding, addr, size);
+        }
+    }
+    // blocks starting at or above minAddress, the lowest of sufficient size first
+    uint64_t alwaysFits = size + alignment - granularity;
+    for (const FreeNode* node = findFirstFit(freeTree.get(), minAddress, size); node != nullptr;
+         node = findFirstFit(freeTree.get(), node->addr + 1, size)) {
+        uint64_t addr = alignUp(node->addr, alignment);
+        if (node->size >= alwaysFits || addr + size <= node->addr + node->size) {
+            return carve(freeByAddress.find(node->addr), addr, size);
+        }
+    }
+    throw std::bad_alloc();
+}
+
+uint64_t RangeAllocator::carve(std::map<uint64_t, uint64_t>::iterator freeIt, uint64_t addr,
+                               uint64_t size) {
+    uint64_t blockStart = freeIt->first;
+    uint64_t blockEnd = freeIt->first + freeIt->second;
+    eraseFree(freeIt);
+    if (addr > blockStart) {
+        insertFree(blockStart, addr - blockStart);
+    }
+    if (addr + size < blockEnd) {
+        insertFree(addr + size, blockEnd - addr - size);
+    }
+    usedBlocks[addr] = size;
+    return addr;
+}
+
+bool RangeAllocator::deallocate(uint64_t addr) {
+    auto used = usedBlocks.find(addr);
+    if (used == usedBlocks.end()) {
+        return false;
+    }
+    uint64_t blockStart = addr;
+    uint64_t blockEnd = addr + used->second;
+    usedBlocks.erase(used);
+
+    auto next = freeByAddress.lower_bound(blockStart);
+    if (next != freeByAddress.end() && next->first == blockEnd) {
+        blockEnd += next->second;
+        next = std::next(next);
+        eraseFree(std::prev(next));
+    }
+    if (next != freeByAddress.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == blockStart) {
+            blockStart = prev->first;
+            eraseFree(prev);
+        }
+    }
+    insertFree(blockStart, blockEnd - blockStart);
+    return true;
+}
+
+bool RangeAllocator::contains(uint64_t addr) const {
+    return addr >= startAddress && addr - startAddress < size;
+}
+
+uint64_t RangeAllocator::getBlockSize(uint64_t addr) const {
+    auto it = usedBlocks.find(addr);
+    return it == usedBlocks.end() ? 0 : it->second;
+}
+
+uint64_t RangeAllocator::getFreeBytes() const { return freeBytes; }
+
+uint64_t RangeAllocator::getLargestFreeBlock() const {
+    return freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+}
+
+std::size_t RangeAllocator::getFreeBlockCount() const { return freeByAddress.size(); }
+
+std::size_t RangeAllocator::getUsedBlockCount() const { return usedBlocks.size(); }
+
+void RangeAllocator::insertFree(uint64_t addr, uint64_t size) {
+    freeByAddress.emplace(addr, size);
+    freeBySize.emplace(size, addr);
+    freeBytes += size;
+
+    auto node = std::make_unique<FreeNode>();
+    node->addr = addr;
+    node->size = size;
+    node->maxSize = size;
+    node->priority = static_cast<uint32_t>(random());
+    std::unique_ptr<FreeNode> lower;
+    std::unique_ptr<FreeNode> upper;
+    split(std::move(freeTree), addr, lower, upper);
+    freeTree = merge(merge(std::move(lower), std::move(node)), std::move(upper));
+}
+
+void RangeAllocator::eraseFree(std::map<uint64_t, uint64_t>::iterator it) {
+    std::unique_ptr<FreeNode> lower;
+    std::unique_ptr<FreeNode> node;
+    std::unique_ptr<FreeNode> upper;
+    split(std::move(freeTree), it->first, lower, upper);
+    split(std::move(upper), it->first + 1, node, upper);
+    freeTree = merge(std::move(lower), std::move(upper));
+
+    freeBySize.erase({it->second, it->first});
+    freeBytes -= it->second;
+    freeByAddress.erase(it);
+}
+
+const RangeAllocator::FreeNode* RangeAllocator::findFirstFit(const FreeNode* node,
+                                                             uint64_t minAddress,
+                                                             uint64_t minSize) {
+    // subtrees without a large enough block are skipped whole, so only the search path for
+    // minAddress and a single descent into a matching subtree are visited
+    if (node == nullptr || node->maxSize < minSize) {
+        return nullptr;
+    }
+    if (node->addr < minAddress) {
+        return findFirstFit(node->right.get(), minAddress, minSize);
+    }
+    if (const FreeNode* found = findFirstFit(node->left.get(), minAddress, minSize)) {
+        return found;
+    }
+    if (node->size >= minSize) {
+        return node;
+    }
+    return findFirstFit(node->right.get(), minAddress, minSize);
+}
+
+void RangeAllocator::split(std::unique_ptr<FreeNode> node, uint64_t addr,
+                           std::unique_ptr<FreeNode>& lower, std::unique_ptr<FreeNode>& upper) {
+    if (!node) {
+        lower.reset();
+        upper.reset();
+        return;
+    }
+    if (node->addr < addr) {
+        split(std::move(node->right), addr, node->right, upper);
+        updateMaxSize(*node);
+        lower = std::move(node);
+    } else {
+        split(std::move(node->left), addr, lower, node->left);
+        updateMaxSize(*node);
+        upper = std::move(node);
+    }
+}
+
+std::unique_ptr<RangeAllocator::FreeNode> RangeAllocator::merge(std::unique_ptr<FreeNode> lower,
+                                                                std::unique_ptr<FreeNode> upper) {
+    if (!lower) {
+        return upper;
+    }
+    if (!upper) {
+        return lower;
+    }
+    if (lower->priority > upper->priority) {
+        lower->right = merge(std::move(lower->right), std::move(upper));
+        updateMaxSize(*lower);
+        return lower;
+    }
+    upper->left = merge(std::move(lower), std::move(upper->left));
+    updateMaxSize(*upper);
+    return upper;
+}
+
+void RangeAllocator::updateMaxSize(FreeNode& node) {
+    node.maxSize = node.size;
+    if (node.left) {
+        node.maxSize = std::max(node.maxSize, node.left->maxSize);
+    }
+    if (node.right) {
+        node.maxSize = std::max(node.maxSize, node.right->maxSize);
+    }
+}
+
+}  // namespace vrt
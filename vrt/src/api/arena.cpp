@@ -0,0 +1,104 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "api/arena.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace vrt {
+
+Arena::Arena(Device device, uint64_t size, MemoryRangeType type)
+    : Arena(device, size, type, device.getAllocator()->getDefaultPolicy()) {}
+
+Arena::Arena(Device device, uint64_t size, MemoryRangeType type, uint8_t port)
+    : Arena(device, size, type, port, device.getAllocator()->getDefaultPolicy()) {}
+
+Arena::Arena(Device device, uint64_t size, MemoryRangeType type, const AllocationPolicy& policy)
+    : device(device), type(type), policy(policy), size(size) {
+    baseAddress = device.getAllocator()->allocate(size, type, policy);
+    if (baseAddress == 0) {
+        throw std::bad_alloc();
+    }
+}
+
+Arena::Arena(Device device, uint64_t size, MemoryRangeType type, uint8_t port,
+             const AllocationPolicy& policy)
+    : device(device), type(type), policy(policy), size(size) {
+    baseAddress = device.getAllocator()->allocate(size, type, port, policy);
+    if (baseAddress == 0) {
+        throw std::bad_alloc();
+    }
+}
+
+Arena::~Arena() {
+    if (liveBuffers != 0) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Destroying arena with {} live buffers", liveBuffers);
+    }
+    if (baseAddress != 0) {
+        device.getAllocator()->deallocate(baseAddress);
+    }
+}
+
+uint64_t Arena::allocate(uint64_t size) { return allocate(size, policy); }
+
+uint64_t Arena::allocate(uint64_t size, const AllocationPolicy& policy) {
+    size = policy.paddedSize(size);
+    uint64_t alignment = policy.alignmentFor(size);
+    // align the address, the region itself may be less aligned than requested
+    uint64_t addr = (baseAddress + offset + alignment - 1) & ~(alignment - 1);
+    uint64_t end = addr - baseAddress + size;
+    if (end > this->size) {
+        throw std::bad_alloc();
+    }
+    offset = end;
+    peak = std::max(peak, offset);
+    return addr;
+}
+
+void Arena::reset() {
+    if (liveBuffers != 0) {
+        throw std::logic_error("Cannot reset an arena with " + std::to_string(liveBuffers) +
+                               " live buffers");
+    }
+    offset = 0;
+}
+
+uint64_t Arena::getBaseAddress() const { return baseAddress; }
+
+uint64_t Arena::getSize() const { return size; }
+
+uint64_t Arena::getUsedBytes() const { return offset; }
+
+uint64_t Arena::getPeakBytes() const { return peak; }
+
+Device Arena::getDevice() const { return device; }
+
+MemoryRangeType Arena::getType() const { return type; }
+
+const AllocationPolicy& Arena::getPolicy() const { return policy; }
+
+void Arena::attach() { liveBuffers++; }
+
+void Arena::detach() { liveBuffers--; }
+
+}  // namespace vrt
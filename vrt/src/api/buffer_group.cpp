@@ -0,0 +1,149 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "api/buffer_group.hpp"
+
+namespace vrt {
+
+BufferGroup::BufferGroup(Device device, MemoryRangeType type)
+    : device(device), type(type), port(-1) {}
+
+BufferGroup::BufferGroup(Device device, MemoryRangeType type, uint8_t port)
+    : device(device), type(type), port(port) {}
+
+BufferGroup::~BufferGroup() {
+    if (startAddress != 0) {
+        if (device.getPlatform() == Platform::EMULATION) {
+            for (std::size_t member = 0; member < members.size(); member++) {
+                device.getZmqServer()->freeBuffer(std::to_string(getPhysAddr(member)));
+            }
+        }
+        device.getAllocator()->deallocate(startAddress);
+    }
+    if (hostSlab != nullptr) {
+        device.getHostAllocator()->deallocate(hostSlab);
+    }
+}
+
+std::size_t BufferGroup::addMember(std::size_t size, std::size_t alignment) {
+    if (isAllocated()) {
+        throw std::logic_error("Cannot add members to an allocated buffer group");
+    }
+    alignment = std::max(alignment, MEMBER_ALIGNMENT);
+    std::size_t offset = (totalSize + alignment - 1) / alignment * alignment;
+    members.push_back({offset, size});
+    totalSize = offset + size;
+    return members.size() - 1;
+}
+
+void BufferGroup::allocate() {
+    if (isAllocated()) {
+        throw std::logic_error("Buffer group is already allocated");
+    }
+    if (members.empty()) {
+        throw std::logic_error("Buffer group has no members");
+    }
+    // pad the tail so the last member ends on a full beat as well
+    totalSize = (totalSize + MEMBER_ALIGNMENT - 1) / MEMBER_ALIGNMENT * MEMBER_ALIGNMENT;
+    startAddress = port < 0 ? device.getAllocator()->allocate(totalSize, type)
+                            : device.getAllocator()->allocate(totalSize, type, port);
+    if (startAddress == 0) {
+        throw std::bad_alloc();
+    }
+    hostSlab = static_cast<char*>(device.getHostAllocator()->allocate(totalSize));
+    std::memset(hostSlab, 0, totalSize);
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                       "Allocated group of {} members, {x} bytes at {x}", members.size(),
+                       totalSize, startAddress);
+
+    if (device.getPlatform() == Platform::EMULATION) {
+        // create every member zeroed in the emulation environment, the emulator names them by
+        // address and only writes ranges of buffers it knows
+        for (std::size_t member = 0; member < members.size(); member++) {
+            device.getZmqServer()->allocateBuffer(std::to_string(getPhysAddr(member)),
+                                                  members[member].size);
+        }
+    }
+}
+
+bool BufferGroup::isAllocated() const { return hostSlab != nullptr; }
+
+const BufferGroup::Member& BufferGroup::getMember(std::size_t member) const {
+    if (member >= members.size()) {
+        throw std::out_of_range("Invalid buffer group member");
+    }
+    if (!isAllocated()) {
+        throw std::logic_error("Buffer group is not allocated");
+    }
+    return members[member];
+}
+
+uint64_t BufferGroup::getPhysAddr(std::size_t member) const {
+    return startAddress + getMember(member).offset;
+}
+
+std::size_t BufferGroup::getMemberSize(std::size_t member) const {
+    if (member >= members.size()) {
+        throw std::out_of_range("Invalid buffer group member");
+    }
+    return members[member].size;
+}
+
+std::size_t BufferGroup::getMemberCount() const { return members.size(); }
+
+uint64_t BufferGroup::getPhysAddr() const { return startAddress; }
+
+void* BufferGroup::getHostPtr() const { return hostSlab; }
+
+std::size_t BufferGroup::getSizeInBytes() const { return totalSize; }
+
+std::vector<SyncRange> BufferGroup::getSyncRanges(SyncType syncType) const {
+    std::vector<SyncRange> ranges;
+    ranges.reserve(members.size());
+    for (std::size_t i = 0; i < members.size(); i++) {
+        std::size_t end = (i + 1 < members.size()) ? members[i + 1].offset : totalSize;
+        ranges.push_back({members[i].offset, end - members[i].offset, members[i].offset});
+    }
+    return ranges;
+}
+
+void BufferGroup::markSynced(SyncType syncType) {}
+
+void BufferGroup::sync(SyncType syncType) {
+    if (!isAllocated()) {
+        throw std::logic_error("Buffer group is not allocated");
+    }
+    if (device.getPlatform() != Platform::SIMULATION) {
+        device.syncAll({this}, syncType);
+        return;
+    }
+    std::shared_ptr<ZmqServer> server = device.getZmqServer();
+    if (syncType == SyncType::HOST_TO_DEVICE) {
+        std::vector<uint8_t> sendData(hostSlab, hostSlab + totalSize);
+        server->sendBufferSim(startAddress, sendData);
+    } else {
+        std::vector<uint8_t> recvData;
+        server->fetchBufferSim(startAddress, totalSize, recvData);
+        std::memcpy(hostSlab, recvData.data(), std::min<std::size_t>(recvData.size(), totalSize));
+    }
+}
+
+}  // namespace vrt
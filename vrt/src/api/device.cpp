@@ -20,6 +20,10 @@
 
 #include "api/device.hpp"
 
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
 namespace vrt {
 
 Device::Device(const std::string& bdf, const std::string& vrtbinPath, bool program,
@@ -28,11 +32,14 @@ Device::Device(const std::string& bdf, const std::string& vrtbinPath, bool progr
     lockPcieDevice(bdf);
     this->bdf = bdf;
     this->allocator = new Allocator(4096);
+    shareMemoryStats();
     this->systemMap = this->vrtbin.getSystemMapPath();
     this->pdiPath = this->vrtbin.getPdiPath();
     this->programType = programType;
     this->qdmaIntf = QdmaIntf(bdf);
     this->zmqServer = std::make_shared<ZmqServer>();
+    this->ioEngine = std::make_shared<IoEngine>();
+    this->hostAllocator = std::make_shared<HostAllocator>();
     findPlatform();
     if (platform == Platform::HARDWARE) {
         createAmiDev();
@@ -41,7 +48,17 @@ Device::Device(const std::string& bdf, const std::string& vrtbinPath, bool progr
             programDevice();
         }
         parseSystemMap();
+        // created after programming, which may replace the AMI device handle
+        qdmaLogic = std::make_shared<QdmaLogic>(dev, "qdma_logic", QDMA_LOGIC_BASE,
+                                                QDMA_LOGIC_OFFSET);
         this->clkWiz.setRateHz(clockFreq, false);
+        qdmaIntf.setQueueCount(QDMA_MM_QUEUE_COUNT);
+        uint8_t numaNode;
+        if (ami_dev_get_pci_numa_node(dev, &numaNode) == AMI_STATUS_OK && numaNode != 0xFF) {
+            hostAllocator->setNumaNode(numaNode);
+        }
+        qdmaIntf.setStagingAllocator(hostAllocator);
+        loadTransferConfig();
     } else if (platform == Platform::EMULATION) {
         parseSystemMap();
         std::string emulationExecPath = this->vrtbin.getEmulationExec() + " >/dev/null";
@@ -82,17 +99,34 @@ void Device::parseSystemMap() {
 
 Kernel Device::getKernel(const std::string& name) { return kernels[name]; }
 
+void Device::shareMemoryStats() {
+    // segments are named after the PCIe bus, as v80-smi addresses devices by bus
+    std::string bus = bdf;
+    if (std::count(bus.begin(), bus.end(), ':') > 1) {
+        bus = bus.substr(bus.find(':') + 1);  // drop the PCI domain
+    }
+    bus = bus.substr(0, bus.find(':'));
+    char name[64];
+    std::snprintf(name, sizeof(name), MEMORY_STATS_SHM_NAME, bus.c_str());
+    try {
+        allocator->shareStats(name);
+    } catch (const std::exception& e) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Memory statistics of device {} are not shared: {}", bdf, e.what());
+    }
+}
+
 void Device::cleanup() {
+    allocator->unshareStats();
     if (platform == Platform::HARDWARE) {
         for (auto qdmaIntf_ : qdmaIntfs) {
             delete qdmaIntf_;
         }
+        qdmaIntf.close();
         ami_dev_delete(&dev);
         unlockPcieDevice(bdf);
     } else if (platform == Platform::EMULATION || platform == Platform::SIMULATION) {
-        Json::Value exit;
-        exit["command"] = "exit";
-        zmqServer->sendCommand(exit);
+        zmqServer->shutdown();
     }
 }
 
@@ -176,7 +210,8 @@ void Device::programDevice() {
                 XMLParser parser(systemMap);
                 parser.parseXML();
                 auto qdmaConns = parser.getQdmaConnections();
-                std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf + " --mm 0 bi";
+                std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf +
+                                  QdmaIntf::getMmQueueSetupArgs();
                 for (auto& qdmaConn : qdmaConns) {
                     uint32_t qid = qdmaConn.getQid();
                     std::string direction =
@@ -216,7 +251,8 @@ void Device::bootDevice() {
                 XMLParser parser(systemMap);
                 parser.parseXML();
                 auto qdmaConns = parser.getQdmaConnections();
-                std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf + " --mm 0 bi";
+                std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf +
+                                  QdmaIntf::getMmQueueSetupArgs();
                 for (auto& qdmaConn : qdmaConns) {
                     uint32_t qid = qdmaConn.getQid();
                     std::string direction =
@@ -240,7 +276,8 @@ void Device::bootDevice() {
             XMLParser parser(systemMap);
             parser.parseXML();
             auto qdmaConns = parser.getQdmaConnections();
-            std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf + " --mm 0 bi";
+            std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf +
+                              QdmaIntf::getMmQueueSetupArgs();
             for (auto& qdmaConn : qdmaConns) {
                 uint32_t qid = qdmaConn.getQid();
                 std::string direction =
@@ -284,7 +321,8 @@ void Device::bootDevice() {
             XMLParser parser(systemMap);
             parser.parseXML();
             auto qdmaConns = parser.getQdmaConnections();
-            std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf + " --mm 0 bi";
+            std::string cmd = "sudo bash " + std::string(QDMA_SETUP_QUEUES) + bdf +
+                              QdmaIntf::getMmQueueSetupArgs();
             for (auto& qdmaConn : qdmaConns) {
                 uint32_t qid = qdmaConn.getQid();
                 std::string direction =
@@ -373,10 +411,151 @@ std::shared_ptr<ZmqServer> Device::getZmqServer() { return zmqServer; }
 
 std::vector<QdmaConnection> Device::getQdmaConnections() { return qdmaConnections; }
 
+std::shared_ptr<IoEngine> Device::getIoEngine() { return ioEngine; }
+
+std::shared_ptr<HostAllocator> Device::getHostAllocator() const { return hostAllocator; }
+
 Allocator* Device::getAllocator() { return allocator; }
 
+MemoryStats Device::getMemoryStats() const { return allocator->getStats(); }
+
+void Device::launchMany(const std::vector<KernelLaunch>& launches) {
+    for (std::size_t i = 0; i < launches.size(); i++) {
+        for (std::size_t j = 0; j < i; j++) {
+            if (launches[i].kernel == launches[j].kernel) {
+                throw std::logic_error("Kernel " + launches[i].kernel->getName() +
+                                       " is launched twice in one batch");
+            }
+        }
+    }
+    for (const auto& launch : launches) {
+        launch.kernel->writeLaunchArguments();
+    }
+    for (const auto& launch : launches) {
+        launch.kernel->fireLaunch(launch);
+    }
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__, "Started {} kernels",
+                       launches.size());
+}
+
 std::vector<QdmaIntf*> Device::getQdmaInterfaces() { return qdmaIntfs; }
 
+std::shared_ptr<QdmaLogic> Device::getQdmaLogic() { return qdmaLogic; }
+
+std::string Device::getTransferConfigPath() {
+    return (std::filesystem::path(systemMap).parent_path() / TRANSFER_CONFIG_FILE).string();
+}
+
+void Device::loadTransferConfig() {
+    std::ifstream file(getTransferConfigPath());
+    if (!file.is_open()) {
+        return;
+    }
+    Json::Value root;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    if (!Json::parseFromStream(reader, file, &root, &errors) || !root.isMember("chunk_size") ||
+        !root.isMember("depth") || root["chunk_size"].asUInt64() == 0) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Ignoring invalid transfer configuration {}", getTransferConfigPath());
+        return;
+    }
+    qdmaIntf.setTransferConfig({root["chunk_size"].asUInt64(), root["depth"].asUInt(),
+                                root.get("bandwidth", 0.0).asDouble()});
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                       "Loaded transfer configuration: depth {}, chunk size {x}",
+                       root["depth"].asUInt(), root["chunk_size"].asUInt64());
+}
+
+QdmaTransferConfig Device::calibrateTransfers(uint64_t scratchSize) {
+    if (platform != Platform::HARDWARE) {
+        throw std::runtime_error("Transfer calibration requires a hardware device");
+    }
+    uint64_t scratchAddr = allocator->allocate(scratchSize, MemoryRangeType::HBM);
+    QdmaTransferConfig config;
+    try {
+        config = qdmaIntf.calibrate(scratchAddr, scratchSize);
+    } catch (...) {
+        allocator->deallocate(scratchAddr);
+        throw;
+    }
+    allocator->deallocate(scratchAddr);
+
+    Json::Value root;
+    root["chunk_size"] = Json::UInt64(config.chunkSize);
+    root["depth"] = Json::UInt(config.depth);
+    root["bandwidth"] = config.bandwidth;
+    std::ofstream file(getTransferConfigPath());
+    if (!file.is_open()) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Cannot store transfer configuration in {}", getTransferConfigPath());
+        return config;
+    }
+    file << Json::writeString(Json::StreamWriterBuilder(), root);
+    return config;
+}
+
+void Device::syncAll(const std::vector<BufferBase*>& buffers, SyncType syncType) {
+    for (BufferBase* buffer : buffers) {
+        if (buffer == nullptr) {
+            throw std::invalid_argument("Cannot synchronize a null buffer");
+        }
+    }
+    if (platform == Platform::HARDWARE) {
+        std::vector<QdmaSegment> segments;
+        for (BufferBase* buffer : buffers) {
+            char* hostPtr = static_cast<char*>(buffer->getHostPtr());
+            for (const SyncRange& range : buffer->getSyncRanges(syncType)) {
+                if (range.byteCount > 0) {
+                    segments.push_back({hostPtr + range.byteOffset,
+                                        buffer->getPhysAddr() + range.byteOffset,
+                                        range.byteCount});
+                }
+            }
+        }
+        if (syncType == SyncType::HOST_TO_DEVICE) {
+            qdmaIntf.write_batch(segments);
+        } else {
+            qdmaIntf.read_batch(segments);
+        }
+    } else if (platform == Platform::EMULATION) {
+        std::vector<ZmqBufferRange> ranges;
+        std::vector<char*> hostPtrs;
+        std::vector<uint8_t> data;
+        for (BufferBase* buffer : buffers) {
+            char* hostPtr = static_cast<char*>(buffer->getHostPtr());
+            for (const SyncRange& range : buffer->getSyncRanges(syncType)) {
+                // the emulator names every device object by its start address
+                std::string name = std::to_string(buffer->getPhysAddr() + range.regionOffset);
+                ranges.push_back({name, range.byteOffset - range.regionOffset, range.byteCount});
+                hostPtrs.push_back(hostPtr + range.byteOffset);
+                if (syncType == SyncType::HOST_TO_DEVICE) {
+                    data.insert(data.end(), hostPtrs.back(), hostPtrs.back() + range.byteCount);
+                }
+            }
+        }
+        if (syncType == SyncType::HOST_TO_DEVICE) {
+            zmqServer->sendBufferBatch(ranges, data);
+        } else {
+            data = zmqServer->fetchBufferBatch(ranges);
+            size_t dataOffset = 0;
+            for (size_t i = 0; i < ranges.size() && dataOffset < data.size(); i++) {
+                size_t count = std::min<size_t>(ranges[i].size, data.size() - dataOffset);
+                std::memcpy(hostPtrs[i], data.data() + dataOffset, count);
+                dataOffset += count;
+            }
+        }
+    } else {
+        for (BufferBase* buffer : buffers) {
+            buffer->sync(syncType);
+        }
+        return;
+    }
+    for (BufferBase* buffer : buffers) {
+        buffer->markSynced(syncType);
+    }
+}
+
 void Device::lockPcieDevice(const std::string& bdf) {
     std::string lockFile = "/tmp/pcie_device_" + bdf + ".lock";
     int fd = open(lockFile.c_str(), O_CREAT | O_WRONLY, 0666);
@@ -20,6 +20,8 @@
 
 #include "api/kernel.hpp"
 
+#include <algorithm>
+
 #include "api/device.hpp"
 
 namespace vrt {
@@ -31,6 +33,38 @@ Kernel::Kernel(ami_device* device, const std::string& name, uint64_t baseAddr, u
     this->baseAddr = baseAddr;
     this->range = range;
     this->registers = registers;
+    buildArgumentPlan();
+}
+
+namespace {
+/**
+ * @brief Checks if a register holds part of a wide argument, i.e. its name ends in _<n>.
+ */
+bool isSplitRegister(const std::string& name) {
+    std::size_t underscore = name.find_last_of('_');
+    return underscore != std::string::npos && underscore + 1 < name.size() &&
+           name.find_first_not_of("0123456789", underscore + 1) == std::string::npos;
+}
+}  // namespace
+
+void Kernel::buildArgumentPlan() {
+    argumentPlan.clear();
+    registerValues.clear();
+    if (registers.empty()) {
+        return;
+    }
+    // the first four registers are the control block, arguments follow
+    for (std::size_t i = 4; i < registers.size();) {
+        ArgumentSlot slot;
+        slot.offset = registers[i].getOffset();
+        slot.wide = isSplitRegister(registers[i].getRegisterName()) && i + 1 < registers.size();
+        slot.highOffset = slot.wide ? registers[i + 1].getOffset() : slot.offset;
+        slot.emulatorName = "arg" + std::to_string(argumentPlan.size());
+        argumentPlan.push_back(std::move(slot));
+        i += argumentPlan.back().wide ? 2 : 1;
+    }
+    registerValues.assign(
+        (registers.back().getOffset() + sizeof(uint32_t)) / sizeof(uint32_t), 0);
 }
 
 Kernel::Kernel(Device& device, const std::string& kernelName)
@@ -45,15 +79,10 @@ void Kernel::write(uint32_t offset, uint32_t value) {
         utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
                            "Writing to device {} kernel: {} at offset: {x} value: {x}", deviceBdf,
                            name, offset, value);
-        uint32_t* buf = (uint32_t*)calloc(1, sizeof(uint32_t));
-        *buf = value;
-        if (buf) {
-            int ret = ami_mem_bar_write(dev, bar, baseAddr - BASE_BAR_ADDR + offset, buf[0]);
-            if (ret != AMI_STATUS_OK) {
-                throw std::runtime_error("Failed to write to device");
-            }
+        int ret = ami_mem_bar_write(dev, bar, baseAddr - BASE_BAR_ADDR + offset, value);
+        if (ret != AMI_STATUS_OK) {
+            throw std::runtime_error("Failed to write to device");
         }
-        free(buf);
     } else if (platform == Platform::SIMULATION) {
         server->sendScalar(baseAddr + offset, value);
     }
@@ -65,30 +94,17 @@ uint32_t Kernel::read(uint32_t offset) {
             utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
                                "Reading from device {} kernel: {} at offset: {x}", deviceBdf, name,
                                offset);
-        uint32_t* buf = (uint32_t*)calloc(1, sizeof(uint32_t));
-        if (buf) {
-            int ret = ami_mem_bar_read(dev, bar, baseAddr - BASE_BAR_ADDR + offset, &buf[0]);
-            if (ret != AMI_STATUS_OK) {
-                throw std::runtime_error("Failed to read from device");
-            }
+        uint32_t value = 0;
+        int ret = ami_mem_bar_read(dev, bar, baseAddr - BASE_BAR_ADDR + offset, &value);
+        if (ret != AMI_STATUS_OK) {
+            throw std::runtime_error("Failed to read from device");
         }
-        uint32_t value = buf[0];
-        free(buf);
         return value;
     } else if (platform == Platform::EMULATION) {
-        currentRegisterIndex = 4;
-        std::size_t argIdx = 0;
-        while (currentRegisterIndex < registers.size()) {
-            std::regex re(".*_\\d+$");
-            if (std::regex_match(registers.at(currentRegisterIndex).getRegisterName(), re)) {
-                currentRegisterIndex += 2;
-            } else {
-                if (registers.at(currentRegisterIndex).getOffset() == offset) {
-                    return server->fetchScalar(name, "arg" + std::to_string(argIdx));
-                }
-                currentRegisterIndex++;
+        for (const ArgumentSlot& slot : argumentPlan) {
+            if (!slot.wide && slot.offset == offset) {
+                return server->fetchScalar(name, slot.emulatorName);
             }
-            argIdx++;
         }
     } else if (platform == Platform::SIMULATION) {
         return server->fetchScalarSim(baseAddr + offset);
@@ -98,15 +114,105 @@ uint32_t Kernel::read(uint32_t offset) {
 
 void Kernel::setDevice(ami_device* device) { this->dev = device; }
 
-void Kernel::wait() {
+void Kernel::wait() { wait(WAIT_FOREVER); }
+
+bool Kernel::wait(std::chrono::nanoseconds timeout) {
+    if (persistent) {
+        throw std::logic_error("Kernel " + name + " runs persistently, stop it instead");
+    }
+    AdaptivePoller poller(remainingRuntime(), timeout);
+    while (!isDone()) {
+        if (!poller.pause()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Kernel::isDone() {
     if (platform == Platform::EMULATION) {
+        return true;
+    }
+    if (persistent) {
+        return false;
+    }
+    // ap_start, alone or with auto_restart, is set while the kernel runs
+    uint32_t control = read(0x00);
+    if (control == 0x01 || control == 0x81) {
+        return false;
+    }
+    recordCompletion();
+    return true;
+}
+
+int Kernel::waitAny(const std::vector<Kernel*>& kernels, std::chrono::nanoseconds timeout) {
+    if (kernels.empty()) {
+        throw std::invalid_argument("No kernels to wait for");
+    }
+    std::chrono::nanoseconds expected = std::chrono::nanoseconds::max();
+    for (Kernel* kernel : kernels) {
+        if (kernel->persistent) {
+            throw std::logic_error("Kernel " + kernel->name + " runs persistently");
+        }
+        expected = std::min(expected, kernel->remainingRuntime());
+    }
+    AdaptivePoller poller(expected, timeout);
+    while (true) {
+        for (std::size_t i = 0; i < kernels.size(); i++) {
+            if (kernels[i]->isDone()) {
+                return static_cast<int>(i);
+            }
+        }
+        if (!poller.pause()) {
+            return -1;
+        }
+    }
+}
+
+bool Kernel::waitAll(const std::vector<Kernel*>& kernels, std::chrono::nanoseconds timeout) {
+    std::chrono::nanoseconds expected{0};
+    for (Kernel* kernel : kernels) {
+        if (kernel->persistent) {
+            throw std::logic_error("Kernel " + kernel->name + " runs persistently");
+        }
+        expected = std::max(expected, kernel->remainingRuntime());
+    }
+    std::vector<Kernel*> pending = kernels;
+    AdaptivePoller poller(expected, timeout);
+    while (true) {
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                     [](Kernel* kernel) { return kernel->isDone(); }),
+                      pending.end());
+        if (pending.empty()) {
+            return true;
+        }
+        if (!poller.pause()) {
+            return false;
+        }
+    }
+}
+
+void Kernel::recordCompletion() {
+    if (!runPending) {
         return;
     }
-    while (read(0x00) == 1 || read(0x00) == 0x81) {
+    runPending = false;
+    auto runtime = std::chrono::steady_clock::now() - startTime;
+    // moving average over roughly the last eight runs
+    expectedRuntime = expectedRuntime.count() == 0 ? runtime : (expectedRuntime * 7 + runtime) / 8;
+}
+
+std::chrono::nanoseconds Kernel::remainingRuntime() const {
+    if (!runPending) {
+        return std::chrono::nanoseconds(0);
     }
+    auto running = std::chrono::steady_clock::now() - startTime;
+    return std::max(std::chrono::nanoseconds(0), expectedRuntime - running);
 }
 
 void Kernel::startKernel(bool autorestart) {
+    startTime = std::chrono::steady_clock::now();
+    runPending = true;
     if (autorestart) {
         write(0x00, 0x81);
     } else {
@@ -119,19 +225,98 @@ Kernel::~Kernel() {}
 void Kernel::setPlatform(Platform platform) { this->platform = platform; }
 
 void Kernel::writeBatch() {
-    uint32_t noOfPhysicalRegisters =
-        (registers.at(registers.size() - 1).getOffset() + sizeof(uint32_t)) / sizeof(uint32_t);
-    uint32_t* buf = (uint32_t*)calloc(noOfPhysicalRegisters, sizeof(uint32_t));
-    for (std::size_t i = 4; i < noOfPhysicalRegisters; i++) {
-        buf[i] = registerMap[i * sizeof(uint32_t)];
-        // buf[i] = registerMap[registers.at(i).getOffset()];
+    for (std::size_t i = 4; i < registerValues.size(); i++) {
         utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
                            "Kernel {}, reg at offset {x}, value: {x}", name, i * sizeof(uint32_t),
-                           buf[i]);
+                           registerValues[i]);
+    }
+    ami_mem_bar_write_range(dev, bar, baseAddr - BASE_BAR_ADDR, registerValues.size(),
+                            registerValues.data());
+}
+
+void Kernel::writeLaunchArguments() {
+    // simulation writes each argument in bind(), emulation sends them with the start command
+    if (platform == Platform::HARDWARE) {
+        writeBatch();
     }
-    ami_mem_bar_write_range(dev, bar, baseAddr - BASE_BAR_ADDR, noOfPhysicalRegisters, buf);
-    free(buf);
 }
+
+void Kernel::fireLaunch(const KernelLaunch& launch) {
+    if (platform == Platform::EMULATION) {
+        server->sendCommand(launch.command);
+    } else {
+        startKernel();
+    }
+}
+
+void Kernel::writeArgumentRegisters() {
+    if (registerValues.size() <= FIRST_ARGUMENT_REGISTER) {
+        return;
+    }
+    // the control registers of the running kernel are left alone
+    ami_mem_bar_write_range(dev, bar,
+                            baseAddr - BASE_BAR_ADDR + FIRST_ARGUMENT_REGISTER * sizeof(uint32_t),
+                            registerValues.size() - FIRST_ARGUMENT_REGISTER,
+                            registerValues.data() + FIRST_ARGUMENT_REGISTER);
+}
+
+bool Kernel::waitArgumentsLatched(std::chrono::nanoseconds timeout) {
+    if (!persistent || platform == Platform::EMULATION) {
+        return true;
+    }
+    AdaptivePoller poller(remainingRuntime(), timeout);
+    // ap_start is a level cleared only when the kernel latched its inputs, nothing is lost
+    // between two reads
+    while (read(0x00) & AP_START) {
+        if (!poller.pause()) {
+            return false;
+        }
+    }
+    // the time from setting ap_start to the latch paces the next wait
+    recordCompletion();
+    return true;
+}
+
+void Kernel::stopPersistent() { stopPersistent(WAIT_FOREVER); }
+
+bool Kernel::stopPersistent(std::chrono::nanoseconds timeout) {
+    if (!persistent || platform == Platform::EMULATION) {
+        persistent = false;
+        return true;
+    }
+    // one budget covers the latch of the last set and the run on it
+    AdaptivePoller poller(remainingRuntime(), timeout);
+    while (read(0x00) & AP_START) {
+        if (!poller.pause()) {
+            return false;
+        }
+    }
+    recordCompletion();
+    while (!(read(0x00) & AP_IDLE)) {
+        if (!poller.pause()) {
+            return false;
+        }
+    }
+    persistent = false;
+    return true;
+}
+
+bool Kernel::isPersistent() const { return persistent; }
+
 std::string Kernel::getName() const { return name; }
 
+void Kernel::setMemoryPort(const std::string& name, uint8_t port) { memoryPorts[name] = port; }
+
+bool Kernel::hasMemoryPort(const std::string& name) const {
+    return memoryPorts.find(name) != memoryPorts.end();
+}
+
+uint8_t Kernel::getMemoryPort(const std::string& name) const {
+    auto it = memoryPorts.find(name);
+    if (it == memoryPorts.end()) {
+        throw std::out_of_range("No HBM port assigned to " + name + " of kernel " + this->name);
+    }
+    return it->second;
+}
+
 }  // namespace vrt
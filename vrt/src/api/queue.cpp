@@ -0,0 +1,281 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "api/queue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "utils/adaptive_poller.hpp"
+#include "utils/logger.hpp"
+
+namespace vrt {
+
+/// Number of resources tracked before completed users are pruned
+constexpr std::size_t QUEUE_PRUNE_THRESHOLD = 1024;
+
+QueueEvent::QueueEvent(std::shared_ptr<QueueCommand> command)
+    : command(command), future(command->promise.get_future().share()) {}
+
+void QueueEvent::wait() const {
+    if (future.valid()) {
+        future.get();
+    }
+}
+
+bool QueueEvent::ready() const {
+    return !future.valid() ||
+           future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+Queue::Queue(Device device, QueueMode mode)
+    : device(device), mode(mode), engine(device.getIoEngine()) {
+    if (!engine) {
+        throw std::runtime_error("Device has no I/O engine");
+    }
+    monitor = std::thread(&Queue::monitorLoop, this);
+}
+
+Queue::~Queue() {
+    try {
+        finish();
+    } catch (const std::exception& e) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Unhandled error of a queued command: {}", e.what());
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    monitor.join();
+}
+
+QueueEvent Queue::enqueueSync(BufferBase& buffer, SyncType syncType) {
+    return enqueueSync({}, buffer, syncType);
+}
+
+QueueEvent Queue::enqueueSync(const std::vector<QueueEvent>& dependencies, BufferBase& buffer,
+                              SyncType syncType) {
+    auto command = std::make_shared<QueueCommand>();
+    command->action = [&buffer, syncType]() { buffer.sync(syncType); };
+    return enqueue(command, dependencies, {&buffer});
+}
+
+QueueEvent Queue::enqueueCallback(std::function<void()> callback) {
+    return enqueueCallback({}, std::move(callback));
+}
+
+QueueEvent Queue::enqueueCallback(const std::vector<QueueEvent>& dependencies,
+                                  std::function<void()> callback) {
+    auto command = std::make_shared<QueueCommand>();
+    command->action = std::move(callback);
+    return enqueue(command, dependencies, {});
+}
+
+void Queue::finish() {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return outstanding == 0; });
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+QueueMode Queue::getMode() const { return mode; }
+
+QueueEvent Queue::enqueue(const std::shared_ptr<QueueCommand>& command,
+                          const std::vector<QueueEvent>& dependencies,
+                          const std::vector<const void*>& resources) {
+    QueueEvent event(command);
+    std::unique_lock<std::mutex> lock(mutex);
+    for (const QueueEvent& dependency : dependencies) {
+        if (dependency.command && dependency.command->queue != this) {
+            throw std::invalid_argument("Dependency belongs to another queue");
+        }
+    }
+    command->queue = this;
+
+    auto dependOn = [&command](const std::shared_ptr<QueueCommand>& dependency) {
+        if (!dependency || dependency == command) {
+            return;
+        }
+        if (dependency->done) {
+            if (dependency->error && !command->error) {
+                command->error = dependency->error;
+            }
+            return;
+        }
+        auto& dependents = dependency->dependents;
+        if (std::find(dependents.begin(), dependents.end(), command) == dependents.end()) {
+            dependents.push_back(command);
+            command->pendingDependencies++;
+        }
+    };
+    for (const QueueEvent& dependency : dependencies) {
+        dependOn(dependency.command);
+    }
+    if (mode == QueueMode::IN_ORDER) {
+        dependOn(lastCommand);
+    } else {
+        if (lastUse.size() > QUEUE_PRUNE_THRESHOLD) {
+            for (auto it = lastUse.begin(); it != lastUse.end();) {
+                it = it->second->done ? lastUse.erase(it) : std::next(it);
+            }
+        }
+        for (const void* resource : resources) {
+            auto it = lastUse.find(resource);
+            if (it != lastUse.end()) {
+                dependOn(it->second);
+            }
+        }
+    }
+    lastCommand = command;
+    for (const void* resource : resources) {
+        lastUse[resource] = command;
+    }
+    outstanding++;
+
+    bool ready = command->pendingDependencies == 0;
+    lock.unlock();
+    if (ready) {
+        if (command->error) {
+            complete(command, command->error);
+        } else {
+            issue(command);
+        }
+    }
+    return event;
+}
+
+void Queue::issue(const std::shared_ptr<QueueCommand>& command) {
+    engine->submit([this, command]() {
+        try {
+            command->action();
+        } catch (...) {
+            complete(command, std::current_exception());
+            return;
+        }
+        if (command->kernel) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                runningKernels.push_back(command);
+            }
+            condition.notify_all();
+        } else {
+            complete(command, nullptr);
+        }
+    });
+}
+
+void Queue::complete(const std::shared_ptr<QueueCommand>& command, std::exception_ptr error) {
+    std::vector<std::shared_ptr<QueueCommand>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        command->done = true;
+        command->error = error;
+        command->action = nullptr;  // releases the captured arguments
+        if (error && !firstError) {
+            firstError = error;
+        }
+        for (auto& dependent : command->dependents) {
+            if (error && !dependent->error) {
+                dependent->error = error;
+            }
+            if (--dependent->pendingDependencies == 0) {
+                ready.push_back(dependent);
+            }
+        }
+        command->dependents.clear();
+    }
+    if (error) {
+        command->promise.set_exception(error);
+    } else {
+        command->promise.set_value();
+    }
+    // dependents of a failed command are skipped and fail with its error
+    for (auto& dependent : ready) {
+        if (dependent->error) {
+            complete(dependent, dependent->error);
+        } else {
+            issue(dependent);
+        }
+    }
+    // notify under the lock: finish() may return and destroy the queue right after
+    std::lock_guard<std::mutex> lock(mutex);
+    outstanding--;
+    condition.notify_all();
+}
+
+void Queue::monitorLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        condition.wait(lock, [this] { return stopping || !runningKernels.empty(); });
+        if (runningKernels.empty()) {
+            return;
+        }
+        std::vector<std::shared_ptr<QueueCommand>> running = runningKernels;
+        lock.unlock();
+
+        std::chrono::nanoseconds expected = std::chrono::nanoseconds::max();
+        for (auto& command : running) {
+            expected = std::min(expected, command->kernel->remainingRuntime());
+        }
+        // one thread polls all running kernels, pacing itself by the earliest expected one
+        AdaptivePoller poller(expected, Kernel::WAIT_FOREVER);
+        std::vector<std::pair<std::shared_ptr<QueueCommand>, std::exception_ptr>> finished;
+        while (true) {
+            for (auto& command : running) {
+                try {
+                    if (command->kernel->isDone()) {
+                        finished.emplace_back(command, nullptr);
+                    }
+                } catch (...) {
+                    finished.emplace_back(command, std::current_exception());
+                }
+            }
+            if (!finished.empty()) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                if (runningKernels.size() != running.size()) {
+                    break;  // a kernel was started, poll it too
+                }
+            }
+            poller.pause();
+        }
+
+        lock.lock();
+        for (auto& entry : finished) {
+            runningKernels.erase(
+                std::find(runningKernels.begin(), runningKernels.end(), entry.first));
+        }
+        lock.unlock();
+        for (auto& entry : finished) {
+            complete(entry.first, entry.second);
+        }
+        lock.lock();
+    }
+}
+
+}  // namespace vrt
@@ -0,0 +1,237 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "api/stream_ring.hpp"
+
+#include <cstring>
+
+namespace vrt {
+
+StreamRing::StreamRing(Device device, Kernel kernel, const std::string& portName,
+                       std::size_t slotSize, std::size_t slotCount)
+    : device(device), slotSize(slotSize) {
+    if (slotSize == 0 || slotCount == 0) {
+        throw std::invalid_argument("Stream ring needs at least one non-empty slot");
+    }
+    bool gotQdma = false;
+    for (const auto& con : device.getQdmaConnections()) {
+        if (con.getKernel() == kernel.getName() && portName == con.getInterface()) {
+            qid = con.getQid();
+            direction = con.getDirection();
+            gotQdma = true;
+        }
+    }
+    if (!gotQdma) {
+        throw std::runtime_error("No QDMA connection found for kernel " + kernel.getName() +
+                                 " and port " + portName);
+    }
+    name = (direction == StreamDirection::HOST_TO_DEVICE)
+               ? ("streamingBuffer_" + std::to_string(qid))
+               : ("outputStreamingBuffer_" + std::to_string(qid));
+    if (device.getPlatform() == Platform::HARDWARE) {
+        for (auto& qdmaIntf : device.getQdmaInterfaces()) {
+            if (qdmaIntf->getQueueIdx() == qid) {
+                qdmaInterface = qdmaIntf;
+            }
+        }
+        if (qdmaInterface == nullptr) {
+            throw std::runtime_error("No QDMA interface for queue " + std::to_string(qid));
+        }
+    }
+
+    memory = static_cast<char*>(device.getHostAllocator()->allocate(slotSize * slotCount));
+    // H2C slots start out empty with the application, C2H slots start out to be filled
+    std::deque<Slot>& initial =
+        (direction == StreamDirection::HOST_TO_DEVICE) ? appSlots : workSlots;
+    for (std::size_t i = 0; i < slotCount; i++) {
+        initial.push_back({memory + i * slotSize, slotSize, i});
+    }
+}
+
+StreamRing::~StreamRing() {
+    stop();
+    device.getHostAllocator()->deallocate(memory);
+}
+
+void StreamRing::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+    running = true;
+    stopping = false;
+    interrupted = false;
+    worker = std::thread(&StreamRing::run, this);
+}
+
+void StreamRing::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        stopping = true;
+    }
+    interrupted = true;
+    cv.notify_all();
+    worker.join();
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+}
+
+void StreamRing::run() {
+    while (true) {
+        Slot slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !workSlots.empty(); });
+            if (stopping) {
+                return;
+            }
+            slot = workSlots.front();
+            workSlots.pop_front();
+            busySlots++;
+        }
+        try {
+            std::size_t bytes = transfer(slot);
+            std::lock_guard<std::mutex> lock(mutex);
+            busySlots--;
+            if (direction == StreamDirection::DEVICE_TO_HOST && bytes == 0 && interrupted) {
+                // nothing arrived before stop(), the slot is filled after the next start
+                workSlots.push_front(slot);
+                continue;
+            }
+            transferredBytes += bytes;
+            slot.size = (direction == StreamDirection::HOST_TO_DEVICE) ? slotSize : bytes;
+            appSlots.push_back(slot);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            busySlots--;
+            error = std::current_exception();
+            stopping = true;
+        }
+        cv.notify_all();
+    }
+}
+
+std::size_t StreamRing::transfer(Slot& slot) {
+    Platform platform = device.getPlatform();
+    if (direction == StreamDirection::HOST_TO_DEVICE) {
+        if (platform == Platform::HARDWARE) {
+            qdmaInterface->write_buff(slot.data, 0, slot.size);
+        } else if (platform == Platform::EMULATION) {
+            device.getZmqServer()->sendStream(
+                name, std::vector<uint8_t>(slot.data, slot.data + slot.size));
+        } else {
+            throw std::runtime_error("Stream ring not implemented for this platform.");
+        }
+        return slot.size;
+    }
+
+    if (platform == Platform::HARDWARE) {
+        // a slot may span several packets, a short packet ends the slot
+        std::shared_ptr<QdmaLogic> logic = device.getQdmaLogic();
+        std::size_t received = 0;
+        while (received < slotSize) {
+            uint32_t length = std::min<std::size_t>(QDMA_ST_MAX_PACKET_SIZE, slotSize - received);
+            logic->setValues(qid, length);
+            uint64_t bytes =
+                qdmaInterface->read_packet(slot.data + received, length, &interrupted);
+            received += bytes;
+            if (bytes < length || interrupted) {
+                break;
+            }
+        }
+        return received;
+    } else if (platform == Platform::EMULATION) {
+        std::vector<uint8_t> recvData = device.getZmqServer()->fetchStream(name, slotSize);
+        std::size_t received = std::min(recvData.size(), slotSize);
+        std::memcpy(slot.data, recvData.data(), received);
+        return received;
+    }
+    throw std::runtime_error("Stream ring not implemented for this platform.");
+}
+
+void StreamRing::checkError() {
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+StreamRing::Slot StreamRing::acquire() {
+    start();
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return error || !appSlots.empty(); });
+    checkError();
+    Slot slot = appSlots.front();
+    appSlots.pop_front();
+    return slot;
+}
+
+bool StreamRing::acquireFor(Slot& slot, std::chrono::microseconds timeout) {
+    start();
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!cv.wait_for(lock, timeout, [this] { return error || !appSlots.empty(); })) {
+        return false;
+    }
+    checkError();
+    slot = appSlots.front();
+    appSlots.pop_front();
+    return true;
+}
+
+void StreamRing::commit(const Slot& slot, std::size_t bytes) {
+    if (slot.data != memory + slot.id * slotSize) {
+        throw std::invalid_argument("Slot does not belong to this ring");
+    }
+    if (bytes > slotSize) {
+        throw std::out_of_range("Slot size exceeded");
+    }
+    start();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        checkError();
+        Slot committed = slot;
+        committed.size = (direction == StreamDirection::HOST_TO_DEVICE) ? bytes : slotSize;
+        workSlots.push_back(committed);
+    }
+    cv.notify_all();
+}
+
+void StreamRing::commit(const Slot& slot) { commit(slot, slot.size); }
+
+void StreamRing::flush() {
+    if (direction != StreamDirection::HOST_TO_DEVICE) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return error || !running || (workSlots.empty() && busySlots == 0); });
+    checkError();
+}
+
+StreamDirection StreamRing::getDirection() const { return direction; }
+
+uint64_t StreamRing::getTransferredBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return transferredBytes;
+}
+
+}  // namespace vrt
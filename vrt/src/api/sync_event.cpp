@@ -0,0 +1,111 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "api/sync_event.hpp"
+
+namespace vrt {
+
+SyncEvent::SyncEvent(std::shared_ptr<State> state, std::shared_ptr<IoEngine> engine)
+    : state(std::move(state)), engine(std::move(engine)) {
+    future = this->state->promise.get_future().share();
+}
+
+SyncEvent SyncEvent::submit(std::shared_ptr<IoEngine> engine, std::function<void()> task) {
+    SyncEvent event(std::make_shared<State>(), engine);
+    std::shared_ptr<State> state = event.state;
+    engine->submit([state, task]() { run(state, task); });
+    return event;
+}
+
+void SyncEvent::run(const std::shared_ptr<State>& state, const std::function<void()>& task) {
+    std::exception_ptr error;
+    try {
+        task();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    complete(state, error);
+}
+
+void SyncEvent::complete(const std::shared_ptr<State>& state, std::exception_ptr error) {
+    std::vector<std::function<void(std::exception_ptr)>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done = true;
+        state->error = error;
+        continuations.swap(state->continuations);
+    }
+    if (error) {
+        state->promise.set_exception(error);
+    } else {
+        state->promise.set_value();
+    }
+    for (auto& continuation : continuations) {
+        continuation(error);
+    }
+}
+
+void SyncEvent::wait() const {
+    if (future.valid()) {
+        future.get();
+    }
+}
+
+bool SyncEvent::waitFor(std::chrono::microseconds timeout) const {
+    if (!future.valid()) {
+        return true;
+    }
+    return future.wait_for(timeout) == std::future_status::ready;
+}
+
+bool SyncEvent::ready() const { return waitFor(std::chrono::microseconds(0)); }
+
+SyncEvent SyncEvent::then(std::function<void()> continuation) const {
+    SyncEvent next(std::make_shared<State>(), engine);
+    std::shared_ptr<State> nextState = next.state;
+    std::shared_ptr<IoEngine> engine = this->engine;
+    auto start = [engine, nextState, continuation](std::exception_ptr error) {
+        if (error) {
+            complete(nextState, error);
+        } else if (!engine) {
+            // a default event has no engine, its continuation runs in place
+            run(nextState, continuation);
+        } else {
+            engine->submit([nextState, continuation]() { run(nextState, continuation); });
+        }
+    };
+    if (!state) {
+        start(nullptr);
+        return next;
+    }
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (!state->done) {
+        state->continuations.push_back(std::move(start));
+        return next;
+    }
+    std::exception_ptr error = state->error;
+    lock.unlock();
+    start(error);
+    return next;
+}
+
+}  // namespace vrt
@@ -29,6 +29,7 @@ XMLParser::XMLParser(const std::string& file_path) {
 }
 
 void XMLParser::parseXML() {
+    std::vector<xmlNode*> memoryNodes;
     for (xmlNode* kernelNode = rootNode->children; kernelNode; kernelNode = kernelNode->next) {
         if (kernelNode->type == XML_ELEMENT_NODE &&
             xmlStrcmp(kernelNode->name, BAD_CAST "Kernel") == 0) {
@@ -103,6 +104,37 @@ void XMLParser::parseXML() {
                 }
             }
             qdmaConnections.push_back({kernelName, qid, qdmaStream, syncTypeStr});
+        } else if (kernelNode->type == XML_ELEMENT_NODE &&
+                   xmlStrcmp(kernelNode->name, BAD_CAST "Memory") == 0) {
+            memoryNodes.push_back(kernelNode);
+        }
+    }
+    // memory ports may precede their kernel in the file
+    for (xmlNode* memoryNode : memoryNodes) {
+        std::string kernelName, interface;
+        std::vector<std::string> arguments;
+        uint8_t port = 0;
+        for (xmlNode* childNode = memoryNode->children; childNode; childNode = childNode->next) {
+            if (childNode->type == XML_ELEMENT_NODE) {
+                std::string content = (const char*)xmlNodeGetContent(childNode);
+                if (xmlStrcmp(childNode->name, BAD_CAST "kernel") == 0) {
+                    kernelName = content;
+                } else if (xmlStrcmp(childNode->name, BAD_CAST "interface") == 0) {
+                    interface = content;
+                } else if (xmlStrcmp(childNode->name, BAD_CAST "argument") == 0) {
+                    arguments.push_back(content);
+                } else if (xmlStrcmp(childNode->name, BAD_CAST "port") == 0) {
+                    port = std::stoi(content);
+                }
+            }
+        }
+        auto kernel = kernels.find(kernelName);
+        if (kernel == kernels.end()) {
+            continue;
+        }
+        kernel->second.setMemoryPort(interface, port);
+        for (auto& argument : arguments) {
+            kernel->second.setMemoryPort(argument, port);
         }
     }
 }
@@ -20,6 +20,10 @@
 
 #include "qdma/qdma_intf.hpp"
 
+#include <chrono>
+#include <cstring>
+#include <deque>
+
 namespace vrt {
 
 QdmaIntf::QdmaIntf(const std::string& bdf) {
@@ -30,6 +34,13 @@ QdmaIntf::QdmaIntf(const std::string& bdf) {
     char formattedQueueName[256];
     sprintf(formattedQueueName, QDMA_DEFAULT_QUEUE, bus);
     queueName = std::string(formattedQueueName);
+    state = std::make_shared<SharedState>();
+    state->stagingAllocator = std::make_shared<HostAllocator>();
+    state->sessions.push_back(std::make_shared<QdmaQueueSession>(queueName));
+    for (uint32_t i = 1; i < QDMA_MM_QUEUE_COUNT; i++) {
+        sprintf(formattedQueueName, QDMA_MM_QUEUE, bus, QDMA_MM_QUEUE_BASE + i - 1);
+        state->sessions.push_back(std::make_shared<QdmaQueueSession>(formattedQueueName));
+    }
     free(bus);
 }
 
@@ -40,9 +51,13 @@ QdmaIntf::QdmaIntf(const std::string& bdf, const uint32_t queueIdx) {
     char formattedQueueName[256];
     sprintf(formattedQueueName, QDMA_DEFAULT_ST_QUEUE, bus, queueIdx);
     queueName = std::string(formattedQueueName);
+    state = std::make_shared<SharedState>();
+    state->stagingAllocator = std::make_shared<HostAllocator>();
+    state->sessions.push_back(std::make_shared<QdmaQueueSession>(queueName));
     free(bus);
 
     this->queueIdx = queueIdx;
+    this->streaming = true;
 }
 
 QdmaIntf::~QdmaIntf() {}
@@ -91,126 +106,379 @@ int QdmaIntf::delete_qdma_queue(const char* bdf) {
     return EXIT_SUCCESS;
 }
 
-ssize_t QdmaIntf::write_from_buffer(const char* fname, char* buffer, uint64_t size, uint64_t base) {
-    int fd = open(queueName.c_str(), O_WRONLY);
-    ssize_t rc;
-    uint64_t count = 0;
-    char* buf = buffer;
-    off_t offset = base;
+void QdmaIntf::write_buff(char* buffer, uint64_t start_addr, uint64_t size) {
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                       "Writing buffer with size: {x} to {} at address {x}", size, queueName,
+                       start_addr);
+    transfer(true, buffer, start_addr, size);
+}
+
+void QdmaIntf::read_buff(char* buffer, uint64_t start_addr, uint64_t size) {
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                       "Reading buffer with size: {x} to {} at address {x}", size, queueName,
+                       start_addr);
+    transfer(false, buffer, start_addr, size);
+}
+
+uint64_t QdmaIntf::read_packet(char* buffer, uint64_t size, const std::atomic<bool>* cancel) {
+    ssize_t rc = state->sessions[0]->readPacket(buffer, size, cancel);
+    if (rc == -ECANCELED) {
+        return 0;
+    }
+    if (rc < 0) {
+        throw std::runtime_error("Failed to read from " + state->sessions[0]->getDevicePath());
+    }
+    return rc;
+}
 
-    do { /* Support zero byte transfer */
-        uint64_t bytes = size - count;
+void QdmaIntf::write_batch(const std::vector<QdmaSegment>& segments) {
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                       "Writing {} segments to {}", segments.size(), queueName);
+    transfer(true, segments);
+}
 
-        if (bytes > RW_MAX_SIZE) bytes = RW_MAX_SIZE;
+void QdmaIntf::read_batch(const std::vector<QdmaSegment>& segments) {
+    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                       "Reading {} segments from {}", segments.size(), queueName);
+    transfer(false, segments);
+}
+
+void QdmaIntf::transfer(bool write, char* buffer, uint64_t start_addr, uint64_t size) {
+    uint64_t stripeSize;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        stripeSize = state->stripeSize;
+    }
+    // staging would cut a stream write into several packets
+    if (!streaming && reinterpret_cast<uintptr_t>(buffer) % HOST_PAGE_SIZE != 0 &&
+        size >= 2 * stripeSize) {
+        transferStaged(write, buffer, start_addr, size);
+        return;
+    }
+    transfer(write, {{buffer, start_addr, size}});
+}
 
-        if (offset) {
-            rc = lseek(fd, offset, SEEK_SET);
-            if (rc < 0) {
-                utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
-                                   "Could not write to {}", fname);
-                return -EIO;
+void QdmaIntf::transferStaged(bool write, char* buffer, uint64_t start_addr, uint64_t size) {
+    uint64_t chunkSize;
+    std::size_t depth;
+    std::shared_ptr<IoEngine> engine;
+    std::shared_ptr<HostAllocator> allocator;
+    std::vector<std::shared_ptr<QdmaQueueSession>> queues;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        chunkSize = state->stripeSize;
+        depth = state->depth ? state->depth : state->activeQueues;
+        engine = state->stripeEngine;
+        allocator = state->stagingAllocator;
+        queues.assign(state->sessions.begin(), state->sessions.begin() + state->activeQueues);
+    }
+    // without workers the DMA runs inline and nothing overlaps
+    if (!engine) {
+        depth = 1;
+    }
+    // one staging buffer per chunk in flight and one for the chunk being copied
+    std::vector<char*> slots(depth + 1);
+    for (auto& slot : slots) {
+        slot = static_cast<char*>(allocator->allocate(chunkSize));
+    }
+
+    uint64_t chunkCount = (size + chunkSize - 1) / chunkSize;
+    auto chunkLength = [&](uint64_t chunk) {
+        return std::min(chunkSize, size - chunk * chunkSize);
+    };
+    auto dma = [&](uint64_t chunk) {
+        QdmaQueueSession& session = *queues[chunk % queues.size()];
+        char* slot = slots[chunk % slots.size()];
+        uint64_t addr = start_addr + chunk * chunkSize;
+        ssize_t rc = write ? session.write(slot, chunkLength(chunk), addr)
+                           : session.read(slot, chunkLength(chunk), addr);
+        if (rc < 0) {
+            throw std::runtime_error((write ? "Failed to write to " : "Failed to read from ") +
+                                     session.getDevicePath());
+        }
+    };
+    auto issue = [&](uint64_t chunk) {
+        if (engine) {
+            return engine->submit([&dma, chunk]() { dma(chunk); });
+        }
+        std::promise<void> done;
+        try {
+            dma(chunk);
+            done.set_value();
+        } catch (...) {
+            done.set_exception(std::current_exception());
+        }
+        return done.get_future().share();
+    };
+
+    // chunks in flight, oldest first
+    std::deque<std::shared_future<void>> pending;
+    std::exception_ptr error;
+    try {
+        if (write) {
+            // copy chunk n while up to depth earlier chunks are in flight
+            for (uint64_t chunk = 0; chunk < chunkCount; chunk++) {
+                std::memcpy(slots[chunk % slots.size()], buffer + chunk * chunkSize,
+                            chunkLength(chunk));
+                if (pending.size() == depth) {
+                    pending.front().get();
+                    pending.pop_front();
+                }
+                pending.push_back(issue(chunk));
+            }
+        } else {
+            // copy out chunk n while the next depth chunks are in flight
+            for (uint64_t chunk = 0; chunk < std::min<uint64_t>(depth, chunkCount); chunk++) {
+                pending.push_back(issue(chunk));
             }
-            if (rc != offset) {
-                utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
-                                   "Could not write to {}", fname);
-                return -EIO;
+            for (uint64_t chunk = 0; chunk < chunkCount; chunk++) {
+                pending.front().get();
+                pending.pop_front();
+                if (chunk + depth < chunkCount) {
+                    pending.push_back(issue(chunk + depth));
+                }
+                std::memcpy(buffer + chunk * chunkSize, slots[chunk % slots.size()],
+                            chunkLength(chunk));
             }
         }
+        while (!pending.empty()) {
+            pending.front().get();
+            pending.pop_front();
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // the staging buffers are only released once no DMA uses them anymore
+    for (auto& future : pending) {
+        future.wait();
+    }
+    for (char* slot : slots) {
+        allocator->deallocate(slot);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
 
-        /* write data to file from memory buffer */
-        rc = write(fd, buf, bytes);
+void QdmaIntf::transfer(bool write, const std::vector<QdmaSegment>& segments) {
+    auto runStripe = [write](QdmaQueueSession& session, const QdmaSegment& stripe) {
+        ssize_t rc = write ? session.write(stripe.buffer, stripe.size, stripe.addr)
+                           : session.read(stripe.buffer, stripe.size, stripe.addr);
         if (rc < 0) {
-            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__, "Could not write to {}",
-                               fname);
-            return -EIO;
-        }
-        if (rc != bytes) {
-            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__, "Could not write to {}",
-                               fname);
-            return -EIO;
+            throw std::runtime_error((write ? "Failed to write to " : "Failed to read from ") +
+                                     session.getDevicePath());
         }
+    };
 
-        count += bytes;
-        buf += bytes;
-        offset += bytes;
-    } while (count < size);
-
-    if (count != size) {
-        utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__, "Could not write to {}",
-                           fname);
-        return -EIO;
+    if (streaming) {
+        for (const QdmaSegment& segment : segments) {
+            runStripe(*state->sessions[0], segment);
+        }
+        return;
     }
-    close(fd);
-    return count;
-}
 
-ssize_t QdmaIntf::read_to_buffer(const char* fname, char* buffer, uint64_t size, uint64_t base) {
-    int fd = open(queueName.c_str(), O_RDONLY);
-    ssize_t rc;
-    uint64_t count = 0;
-    char* buf = buffer;
-    off_t offset = base;
+    std::vector<std::shared_ptr<QdmaQueueSession>> queues;
+    uint64_t stripeSize;
+    std::size_t depth;
+    std::shared_ptr<IoEngine> engine;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        queues.assign(state->sessions.begin(), state->sessions.begin() + state->activeQueues);
+        stripeSize = state->stripeSize;
+        depth = state->depth ? state->depth : state->activeQueues;
+        engine = state->stripeEngine;
+    }
 
-    do { /* Support zero byte transfer */
-        uint64_t bytes = size - count;
+    // segments contiguous on the host and on the device are merged into one transfer
+    std::vector<QdmaSegment> merged;
+    for (const QdmaSegment& segment : segments) {
+        if (!merged.empty() && merged.back().buffer + merged.back().size == segment.buffer &&
+            merged.back().addr + merged.back().size == segment.addr) {
+            merged.back().size += segment.size;
+        } else {
+            merged.push_back(segment);
+        }
+    }
 
-        if (bytes > RW_MAX_SIZE) bytes = RW_MAX_SIZE;
+    // segments of at least two stripes are cut into stripes, smaller ones stay whole
+    std::vector<QdmaSegment> stripes;
+    for (const QdmaSegment& segment : merged) {
+        if (segment.size < 2 * stripeSize) {
+            stripes.push_back(segment);
+            continue;
+        }
+        for (uint64_t offset = 0; offset < segment.size; offset += stripeSize) {
+            stripes.push_back({segment.buffer + offset, segment.addr + offset,
+                               std::min(stripeSize, segment.size - offset)});
+        }
+    }
 
-        if (offset) {
-            rc = lseek(fd, offset, SEEK_SET);
-            if (rc < 0) {
-                utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
-                                   "Could not read from {}", fname);
-                return -EIO;
-            }
-            if (rc != offset) {
-                utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
-                                   "Could not read from {}", fname);
-                return -EIO;
-            }
+    if (depth < 2 || !engine || stripes.size() < 2) {
+        for (const QdmaSegment& stripe : stripes) {
+            runStripe(*queues[0], stripe);
         }
+        return;
+    }
 
-        /* read data from file into memory buffer */
-        rc = read(fd, buf, bytes);
-        if (rc < 0) {
-            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
-                               "Could not read from {}", fname);
-            return -EIO;
+    // lane i issues stripes i, i + lanes, ... on queue i modulo the queue count,
+    // lane 0 runs on the calling thread
+    std::size_t lanes = std::min(depth, stripes.size());
+    auto runLane = [&](std::size_t lane) {
+        for (std::size_t i = lane; i < stripes.size(); i += lanes) {
+            runStripe(*queues[lane % queues.size()], stripes[i]);
         }
-        if (rc != bytes) {
-            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
-                               "Could not read from {}", fname);
-            return -EIO;
+    };
+    std::vector<std::shared_future<void>> pending;
+    for (std::size_t lane = 1; lane < lanes; lane++) {
+        pending.push_back(engine->submit([&runLane, lane]() { runLane(lane); }));
+    }
+    std::exception_ptr error;
+    try {
+        runLane(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : pending) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
         }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
 
-        count += bytes;
-        buf += bytes;
-        offset += bytes;
-    } while (count < size);
+uint32_t QdmaIntf::getQueueIdx() { return queueIdx; }
 
-    if (count != size) {
-        utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__, "Could not read from {}",
-                           fname);
-        return -EIO;
+void QdmaIntf::close() {
+    if (state) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (auto& session : state->sessions) {
+            session->close();
+        }
     }
-    close(fd);
-    return count;
 }
 
-void QdmaIntf::write_buff(char* buffer, uint64_t start_addr, uint64_t size) {
-    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
-                       "Writing buffer with size: {x} to {} at address {x}", size, queueName,
-                       start_addr);
-    write_from_buffer(queueName.c_str(), buffer, size, start_addr);
+std::size_t QdmaIntf::setQueueCount(std::size_t count) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    std::size_t available = 1;
+    while (available < std::min(count, state->sessions.size()) &&
+           access(state->sessions[available]->getDevicePath().c_str(), F_OK) == 0) {
+        available++;
+    }
+    if (available < count) {
+        utils::Logger::log(utils::LogLevel::WARN, __PRETTY_FUNCTION__,
+                           "Requested {} MM queues, using the {} available", count, available);
+    }
+    state->activeQueues = available;
+    // the staged path issues every chunk in flight from a worker while the caller copies
+    reserveWorkers(state->depth ? state->depth : available);
+    return available;
 }
 
-void QdmaIntf::read_buff(char* buffer, uint64_t start_addr, uint64_t size) {
-    utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
-                       "Reading buffer with size: {x} to {} at address {x}", size, queueName,
-                       start_addr);
-    read_to_buffer(queueName.c_str(), buffer, size, start_addr);
+void QdmaIntf::reserveWorkers(std::size_t workers) {
+    if (workers > 0 && (!state->stripeEngine || state->stripeEngine->getWorkerCount() < workers)) {
+        state->stripeEngine = std::make_shared<IoEngine>(workers);
+    }
 }
 
-uint32_t QdmaIntf::getQueueIdx() { return queueIdx; }
+std::size_t QdmaIntf::getQueueCount() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->activeQueues;
+}
+
+void QdmaIntf::setStripeSize(uint64_t stripeSize) {
+    if (stripeSize == 0) {
+        throw std::invalid_argument("Stripe size must not be zero");
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->stripeSize = stripeSize;
+}
+
+uint64_t QdmaIntf::getStripeSize() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->stripeSize;
+}
+
+void QdmaIntf::setInflightDepth(std::size_t depth) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->depth = depth;
+    reserveWorkers(depth ? depth : state->activeQueues);
+}
+
+std::size_t QdmaIntf::getInflightDepth() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->depth ? state->depth : state->activeQueues;
+}
+
+QdmaTransferConfig QdmaIntf::getTransferConfig() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return {state->stripeSize, state->depth ? state->depth : state->activeQueues};
+}
+
+void QdmaIntf::setTransferConfig(const QdmaTransferConfig& config) {
+    setStripeSize(config.chunkSize);
+    setInflightDepth(config.depth);
+}
+
+QdmaTransferConfig QdmaIntf::calibrate(uint64_t scratchAddr, uint64_t scratchSize) {
+    QdmaTransferConfig previous = getTransferConfig();
+    std::size_t maxDepth = 2 * getQueueCount();
+    std::shared_ptr<HostAllocator> allocator;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        allocator = state->stagingAllocator;
+    }
+    char* scratch = static_cast<char*>(allocator->allocate(scratchSize));
+    std::memset(scratch, 0, scratchSize);
+
+    QdmaTransferConfig best = previous;
+    try {
+        for (uint64_t chunkSize = 256 << 10; chunkSize <= scratchSize / 2; chunkSize *= 2) {
+            for (std::size_t depth = 1; depth <= maxDepth; depth *= 2) {
+                setTransferConfig({chunkSize, depth});
+                auto start = std::chrono::steady_clock::now();
+                transfer(true, scratch, scratchAddr, scratchSize);
+                transfer(false, scratch, scratchAddr, scratchSize);
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                double bandwidth = 2.0 * scratchSize / elapsed.count();
+                utils::Logger::log(utils::LogLevel::DEBUG, __PRETTY_FUNCTION__,
+                                   "Depth {}: {} MB/s with chunk size {x}", depth,
+                                   static_cast<uint64_t>(bandwidth / MB_DIV), chunkSize);
+                if (bandwidth > best.bandwidth) {
+                    best = {chunkSize, depth, bandwidth};
+                }
+            }
+        }
+    } catch (...) {
+        allocator->deallocate(scratch);
+        setTransferConfig(previous);
+        throw;
+    }
+    allocator->deallocate(scratch);
+    setTransferConfig(best);
+    utils::Logger::log(utils::LogLevel::INFO, __PRETTY_FUNCTION__,
+                       "Calibrated depth {} at {} MB/s with chunk size {x}", best.depth,
+                       static_cast<uint64_t>(best.bandwidth / MB_DIV), best.chunkSize);
+    return best;
+}
+
+void QdmaIntf::setStagingAllocator(std::shared_ptr<HostAllocator> allocator) {
+    if (!allocator) {
+        throw std::invalid_argument("Staging allocator must not be null");
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->stagingAllocator = allocator;
+}
+
+std::string QdmaIntf::getMmQueueSetupArgs() {
+    std::string args = " --mm 0 bi";
+    for (uint32_t i = 1; i < QDMA_MM_QUEUE_COUNT; i++) {
+        args += " --mm " + std::to_string(QDMA_MM_QUEUE_BASE + i - 1) + " bi";
+    }
+    return args;
+}
 
-}  // namespace vrt
\ No newline at end of file
+}  // namespace vrt
@@ -0,0 +1,150 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "qdma/qdma_queue_session.hpp"
+
+#include <poll.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "qdma/qdma_intf.hpp"
+
+namespace vrt {
+
+QdmaQueueSession::QdmaQueueSession(const std::string& devicePath) : devicePath(devicePath) {}
+
+QdmaQueueSession::~QdmaQueueSession() { close(); }
+
+int QdmaQueueSession::acquireFd(int& fd, int flags) {
+    std::lock_guard<std::mutex> lock(fdMutex);
+    if (fd < 0) {
+        fd = open(devicePath.c_str(), flags);
+        if (fd < 0) {
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not open {}: {}", devicePath, strerror(errno));
+        }
+    }
+    return fd;
+}
+
+ssize_t QdmaQueueSession::write(const char* buffer, uint64_t size, uint64_t offset) {
+    int fd = acquireFd(h2cFd, O_WRONLY);
+    if (fd < 0) {
+        return -EIO;
+    }
+    uint64_t count = 0;
+    do { /* Support zero byte transfer */
+        uint64_t bytes = size - count;
+        if (bytes > RW_MAX_SIZE) bytes = RW_MAX_SIZE;
+
+        ssize_t rc = pwrite(fd, buffer + count, bytes, offset + count);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not write to {}: {}", devicePath, strerror(errno));
+            return -EIO;
+        }
+        if (rc == 0 && bytes != 0) {
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not write to {}", devicePath);
+            return -EIO;
+        }
+        count += rc;
+    } while (count < size);
+    return count;
+}
+
+ssize_t QdmaQueueSession::read(char* buffer, uint64_t size, uint64_t offset) {
+    int fd = acquireFd(c2hFd, O_RDONLY);
+    if (fd < 0) {
+        return -EIO;
+    }
+    uint64_t count = 0;
+    do { /* Support zero byte transfer */
+        uint64_t bytes = size - count;
+        if (bytes > RW_MAX_SIZE) bytes = RW_MAX_SIZE;
+
+        ssize_t rc = pread(fd, buffer + count, bytes, offset + count);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not read from {}: {}", devicePath, strerror(errno));
+            return -EIO;
+        }
+        if (rc == 0 && bytes != 0) {
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not read from {}", devicePath);
+            return -EIO;
+        }
+        count += rc;
+    } while (count < size);
+    return count;
+}
+
+ssize_t QdmaQueueSession::readPacket(char* buffer, uint64_t size,
+                                     const std::atomic<bool>* cancel) {
+    int fd = acquireFd(c2hFd, O_RDONLY);
+    if (fd < 0) {
+        return -EIO;
+    }
+    while (cancel != nullptr) {
+        struct pollfd request = {fd, POLLIN, 0};
+        int ready = poll(&request, 1, QDMA_ST_CANCEL_POLL_MS);
+        if (ready > 0) {
+            break;
+        }
+        if (ready < 0 && errno != EINTR) {
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not poll {}: {}", devicePath, strerror(errno));
+            return -EIO;
+        }
+        if (cancel->load()) {
+            return -ECANCELED;
+        }
+    }
+    while (true) {
+        ssize_t rc = ::read(fd, buffer, std::min<uint64_t>(size, RW_MAX_SIZE));
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            utils::Logger::log(utils::LogLevel::ERROR, __PRETTY_FUNCTION__,
+                               "Could not read from {}: {}", devicePath, strerror(errno));
+            return -EIO;
+        }
+        return rc;
+    }
+}
+
+void QdmaQueueSession::close() {
+    std::lock_guard<std::mutex> lock(fdMutex);
+    if (h2cFd >= 0) {
+        ::close(h2cFd);
+        h2cFd = -1;
+    }
+    if (c2hFd >= 0) {
+        ::close(c2hFd);
+        c2hFd = -1;
+    }
+}
+
+const std::string& QdmaQueueSession::getDevicePath() const { return devicePath; }
+
+}  // namespace vrt
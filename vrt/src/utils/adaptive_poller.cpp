@@ -0,0 +1,63 @@
+/**
+ * The MIT License (MIT)
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "utils/adaptive_poller.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace vrt {
+
+AdaptivePoller::AdaptivePoller(std::chrono::nanoseconds expected, std::chrono::nanoseconds timeout)
+    : start(std::chrono::steady_clock::now()), expected(expected), timeout(timeout) {}
+
+bool AdaptivePoller::pause() {
+    std::chrono::nanoseconds now = elapsed();
+    if (now >= timeout) {
+        return false;
+    }
+    std::chrono::nanoseconds sleep;
+    std::chrono::nanoseconds overrun = now - std::max(expected, std::chrono::nanoseconds(0));
+    if (overrun < -YIELD_TIME) {
+        // far from the expected completion, sleep through half of the remaining time
+        sleep = -overrun / 2;
+    } else if (overrun < std::chrono::nanoseconds(0)) {
+        std::this_thread::yield();
+        return true;
+    } else if (overrun < SPIN_TIME) {
+        return true;
+    } else if (overrun < YIELD_TIME) {
+        std::this_thread::yield();
+        return true;
+    } else {
+        // overrunning, back off in proportion to how long the wait already takes
+        sleep = overrun / 8;
+    }
+    sleep = std::clamp<std::chrono::nanoseconds>(sleep, MIN_SLEEP, MAX_SLEEP);
+    std::this_thread::sleep_for(std::min(sleep, timeout - now));
+    return true;
+}
+
+std::chrono::nanoseconds AdaptivePoller::elapsed() const {
+    return std::chrono::steady_clock::now() - start;
+}
+
+}  // namespace vrt
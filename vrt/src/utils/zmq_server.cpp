@@ -25,6 +25,7 @@ namespace vrt {
 ZmqServer::ZmqServer() : context(1), socket(context, ZMQ_REQ) { socket.connect(address); }
 
 void ZmqServer::sendBuffer(const std::string& name, const std::vector<uint8_t>& buffer) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "populate";
     command["name"] = name;
@@ -43,7 +44,77 @@ void ZmqServer::sendBuffer(const std::string& name, const std::vector<uint8_t>&
     std::string replyStr(static_cast<char*>(reply.data()), reply.size());
 }
 
+void ZmqServer::allocateBuffer(const std::string& name, uint64_t size) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    Json::Value command;
+    command["command"] = "allocate";
+    command["name"] = name;
+    command["size"] = Json::UInt64(size);
+
+    std::string commandStr = Json::writeString(Json::StreamWriterBuilder(), command);
+    zmq::message_t request(commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+}
+
+void ZmqServer::freeBuffer(const std::string& name) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    if (closed) {
+        return;
+    }
+    Json::Value command;
+    command["command"] = "free";
+    command["name"] = name;
+
+    std::string commandStr = Json::writeString(Json::StreamWriterBuilder(), command);
+    zmq::message_t request(commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+}
+
+void ZmqServer::shutdown() {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    if (closed) {
+        return;
+    }
+    closed = true;
+    Json::Value command;
+    command["command"] = "exit";
+
+    std::string commandStr = Json::writeString(Json::StreamWriterBuilder(), command);
+    zmq::message_t request(commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+}
+
+void ZmqServer::sendBufferRange(const std::string& name, uint64_t offset,
+                                const std::vector<uint8_t>& buffer) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    Json::Value command;
+    command["command"] = "populate";
+    command["name"] = name;
+    command["offset"] = Json::UInt64(offset);
+    command["size"] = static_cast<Json::UInt64>(buffer.size());
+
+    std::string commandStr = Json::writeString(Json::StreamWriterBuilder(), command);
+    zmq::message_t request(commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::sndmore);
+
+    zmq::message_t data(buffer.data(), buffer.size());
+    socket.send(data, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+}
+
 void ZmqServer::sendCommand(const Json::Value& command) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::StreamWriterBuilder writer;
     std::string commandStr = Json::writeString(writer, command);
 
@@ -56,6 +127,7 @@ void ZmqServer::sendCommand(const Json::Value& command) {
 }
 
 uint32_t ZmqServer::fetchScalar(const std::string& function, const std::string& argIdx) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "fetch";
     command["type"] = "scalar";
@@ -81,10 +153,44 @@ uint32_t ZmqServer::fetchScalar(const std::string& function, const std::string&
 }
 
 std::vector<uint8_t> ZmqServer::fetchBuffer(const std::string& name) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    Json::Value command;
+    command["command"] = "fetch";
+    command["type"] = "buffer";
+    command["name"] = name;
+
+    Json::StreamWriterBuilder writer;
+    std::string commandStr = Json::writeString(writer, command);
+
+    zmq::message_t request(commandStr.size());
+    memcpy(request.data(), commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+    std::string replyStr(static_cast<char*>(reply.data()), reply.size());
+
+    Json::Value response;
+    Json::Reader reader;
+    reader.parse(replyStr, response);
+
+    std::vector<uint8_t> byteArray;
+    for (const auto& byte : response) {
+        byteArray.push_back(static_cast<uint8_t>(byte.asUInt()));
+    }
+
+    return byteArray;
+}
+
+std::vector<uint8_t> ZmqServer::fetchBufferRange(const std::string& name, uint64_t offset,
+                                                 uint64_t size) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "fetch";
     command["type"] = "buffer";
     command["name"] = name;
+    command["offset"] = Json::UInt64(offset);
+    command["size"] = Json::UInt64(size);
 
     Json::StreamWriterBuilder writer;
     std::string commandStr = Json::writeString(writer, command);
@@ -102,6 +208,68 @@ std::vector<uint8_t> ZmqServer::fetchBuffer(const std::string& name) {
     reader.parse(replyStr, response);
 
     std::vector<uint8_t> byteArray;
+    byteArray.reserve(response.size());
+    for (const auto& byte : response) {
+        byteArray.push_back(static_cast<uint8_t>(byte.asUInt()));
+    }
+
+    return byteArray;
+}
+
+void ZmqServer::sendBufferBatch(const std::vector<ZmqBufferRange>& ranges,
+                                const std::vector<uint8_t>& data) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    Json::Value command;
+    command["command"] = "populate_batch";
+    Json::Value entries(Json::arrayValue);
+    for (const ZmqBufferRange& range : ranges) {
+        Json::Value entry;
+        entry["name"] = range.name;
+        entry["offset"] = Json::UInt64(range.offset);
+        entry["size"] = Json::UInt64(range.size);
+        entries.append(entry);
+    }
+    command["entries"] = entries;
+
+    std::string commandStr = Json::writeString(Json::StreamWriterBuilder(), command);
+    zmq::message_t request(commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::sndmore);
+
+    zmq::message_t payload(data.data(), data.size());
+    socket.send(payload, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+}
+
+std::vector<uint8_t> ZmqServer::fetchBufferBatch(const std::vector<ZmqBufferRange>& ranges) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    Json::Value command;
+    command["command"] = "fetch_batch";
+    Json::Value entries(Json::arrayValue);
+    for (const ZmqBufferRange& range : ranges) {
+        Json::Value entry;
+        entry["name"] = range.name;
+        entry["offset"] = Json::UInt64(range.offset);
+        entry["size"] = Json::UInt64(range.size);
+        entries.append(entry);
+    }
+    command["entries"] = entries;
+
+    std::string commandStr = Json::writeString(Json::StreamWriterBuilder(), command);
+    zmq::message_t request(commandStr.c_str(), commandStr.size());
+    socket.send(request, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    socket.recv(reply);
+    std::string replyStr(static_cast<char*>(reply.data()), reply.size());
+
+    Json::Value response;
+    Json::Reader reader;
+    reader.parse(replyStr, response);
+
+    std::vector<uint8_t> byteArray;
+    byteArray.reserve(response.size());
     for (const auto& byte : response) {
         byteArray.push_back(static_cast<uint8_t>(byte.asUInt()));
     }
@@ -110,6 +278,7 @@ std::vector<uint8_t> ZmqServer::fetchBuffer(const std::string& name) {
 }
 
 void ZmqServer::sendStream(const std::string& name, const std::vector<uint8_t>& buffer) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "stream_in";
     command["name"] = name;
@@ -128,6 +297,7 @@ void ZmqServer::sendStream(const std::string& name, const std::vector<uint8_t>&
 }
 
 std::vector<uint8_t> ZmqServer::fetchStream(const std::string& name, size_t size) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "stream_out";
     command["name"] = name;
@@ -150,6 +320,7 @@ std::vector<uint8_t> ZmqServer::fetchStream(const std::string& name, size_t size
 // hw simulation
 
 void ZmqServer::fetchBufferSim(uint64_t addr, uint64_t size, std::vector<uint8_t>& buffer) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "fetch";
     command["type"] = "buffer";
@@ -177,6 +348,7 @@ void ZmqServer::fetchBufferSim(uint64_t addr, uint64_t size, std::vector<uint8_t
 }
 
 uint32_t ZmqServer::fetchScalarSim(uint64_t addr) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "fetch";
     command["type"] = "scalar";
@@ -201,6 +373,7 @@ uint32_t ZmqServer::fetchScalarSim(uint64_t addr) {
 }
 
 void ZmqServer::sendBufferSim(uint64_t addr, const std::vector<uint8_t>& buffer) {
+    std::lock_guard<std::mutex> lock(socketMutex);
     Json::Value command;
     command["command"] = "populate";
     command["addr"] = Json::UInt64(addr);